@@ -0,0 +1,727 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MAX
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Buffer sizes from MINALLOCBYTES to MAXALLOCBYTES in powers of 4, at most CL_DEVICE_MAX_MEM_ALLOC_SIZE
+// and a quarter of the global memory
+#define MINALLOCBYTES ((size_t)4096)
+#define MAXALLOCBYTES ((size_t)1024 * 1024 * 1024)
+
+// Every size and flag is allocated ALLOCREPS times, the percentiles are over those. Steady state times are
+// the best of NTIMES launches on a buffer that was already touched.
+#define ALLOCREPS 10
+#define NTIMES 10
+
+// Work-items per work-group
+#define LOCALSIZE 256
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print every allocation during test?
+// #define VERBOSE
+
+// Flags the buffers are created with in the first touch tests. COPY_HOST_PTR copies from a host array of ones.
+typedef struct
+{
+	const char *name;
+	cl_mem_flags flags;
+} BufferFlags;
+
+const BufferFlags bufferFlags[] = {
+	{"default", CL_MEM_READ_WRITE},
+	{"ALLOC_HOST_PTR", CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR},
+	{"COPY_HOST_PTR", CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR},
+};
+
+// Function prototypes
+double GetWallTime(void);
+int CompareDoubles(const void *a, const void *b);
+double Percentile(double *samples, int numSamples, int percent);
+double TimeInitKernel(cl_command_queue *queue, cl_kernel *kernel, cl_mem *buffer, size_t bytes);
+double TimeFillBuffer(cl_command_queue *queue, cl_mem *buffer, size_t bytes);
+void RunCreateTests(cl_context *context, size_t maxBytes);
+void RunFirstTouchTests(cl_context *context, cl_command_queue *queue, cl_kernel *kernel, size_t maxBytes);
+void RunFillTests(cl_context *context, cl_command_queue *queue, cl_kernel *kernel, size_t maxBytes);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+	cl_kernel         initKernel;
+	cl_int            err;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	initKernel = clCreateKernel(program, "initialiseDoubleArrayKernel", &err);
+	CheckOpenCLError(err, __LINE__);
+
+	size_t maxBytes = MAXALLOCBYTES;
+	if (maxBytes > maxAlloc)
+		maxBytes = (size_t)maxAlloc;
+	if (maxBytes > globalMemSize / 4)
+		maxBytes = (size_t)(globalMemSize / 4);
+
+	// clCreateBuffer and clReleaseMemObject alone, nothing ever touches the buffers
+	RunCreateTests(&context, maxBytes);
+
+	// Creation, first kernel touch against the steady state and release, for every kind of buffer
+	RunFirstTouchTests(&context, &queue, &initKernel, maxBytes);
+
+	// clEnqueueFillBuffer against the init kernel, on fresh and on touched buffers
+	RunFillTests(&context, &queue, &initKernel, maxBytes);
+
+	clReleaseKernel(initKernel);
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+int CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// Sorts the samples and returns the given percentile, 100 is the max
+double Percentile(double *samples, int numSamples, int percent)
+{
+	qsort(samples, numSamples, sizeof(double), CompareDoubles);
+	int i = numSamples * percent / 100;
+	return samples[i < numSamples ? i : numSamples - 1];
+}
+
+// Runs the init kernel over the whole buffer and waits for it, returns the wall time
+double TimeInitKernel(cl_command_queue *queue, cl_kernel *kernel, cl_mem *buffer, size_t bytes)
+{
+	size_t globalSize = bytes / sizeof(cl_double);
+	size_t localSize = LOCALSIZE;
+	cl_int err;
+
+	err = clSetKernelArg(*kernel, 0, sizeof(cl_mem), buffer);
+	double time = GetWallTime();
+	err |= clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+	clFinish(*queue);
+	time = GetWallTime() - time;
+	CheckOpenCLError(err, __LINE__);
+
+	return time;
+}
+
+// Fills the whole buffer with ones, as the init kernel does, and waits for it. Returns the wall time.
+double TimeFillBuffer(cl_command_queue *queue, cl_mem *buffer, size_t bytes)
+{
+	const cl_double one = 1.0;
+	cl_int err;
+
+	double time = GetWallTime();
+	err = clEnqueueFillBuffer(*queue, *buffer, &one, sizeof(one), 0, bytes, 0, NULL, NULL);
+	clFinish(*queue);
+	time = GetWallTime() - time;
+	CheckOpenCLError(err, __LINE__);
+
+	return time;
+}
+
+// Time of clCreateBuffer and clReleaseMemObject against the size, for buffers that are never used. Many
+// runtimes only reserve the memory here and map it on first use, see RunFirstTouchTests().
+void RunCreateTests(cl_context *context, size_t maxBytes)
+{
+	double create[ALLOCREPS], release[ALLOCREPS];
+	cl_mem buffer;
+	cl_int err;
+
+	printf("clCreateBuffer and clReleaseMemObject of untouched buffers, %d of every size\n", ALLOCREPS);
+	printf("------------------------------------------------------------------------------------\n");
+	printf(" Size (KB)   Create p50 (us)   Create max (us)   Release p50 (us)   Release max (us)\n");
+	printf("------------------------------------------------------------------------------------\n");
+	for (size_t bytes = MINALLOCBYTES; bytes <= maxBytes; bytes *= 4)
+	{
+		for (int r = 0; r < ALLOCREPS; r++)
+		{
+			double time = GetWallTime();
+			buffer = clCreateBuffer(*context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+			create[r] = GetWallTime() - time;
+			CheckOpenCLError(err, __LINE__);
+
+			time = GetWallTime();
+			clReleaseMemObject(buffer);
+			release[r] = GetWallTime() - time;
+		}
+
+		double createP50 = Percentile(create, ALLOCREPS, 50), createMax = Percentile(create, ALLOCREPS, 100);
+		double releaseP50 = Percentile(release, ALLOCREPS, 50), releaseMax = Percentile(release, ALLOCREPS, 100);
+		printf("%10zu   %15.2lf   %15.2lf   %16.2lf   %16.2lf\n", bytes / 1024,
+			   createP50 * 1.0e6, createMax * 1.0e6, releaseP50 * 1.0e6, releaseMax * 1.0e6);
+	}
+	printf("------------------------------------------------------------------------------------\n\n");
+}
+
+// For every kind of buffer and size, ALLOCREPS times: creates a buffer, runs the init kernel on it once (the first
+// touch, which pays for mapping the pages) and releases it. The steady state is the best of NTIMES more launches
+// on the first buffer of every size. First/Steady is how many times slower the first launch is.
+void RunFirstTouchTests(cl_context *context, cl_command_queue *queue, cl_kernel *kernel, size_t maxBytes)
+{
+	double create[ALLOCREPS], first[ALLOCREPS], release[ALLOCREPS];
+	cl_mem buffer;
+	cl_int err;
+
+	// Source of the COPY_HOST_PTR buffers
+	size_t numElements = maxBytes / sizeof(cl_double);
+	cl_double *hostData = malloc(maxBytes);
+	for (size_t i = 0; i < numElements; i++)
+		hostData[i] = 1.0;
+
+	printf("First kernel touch against steady state, %d buffers of every size and flags, steady state is the best of %d launches\n", ALLOCREPS, NTIMES);
+	printf("------------------------------------------------------------------------------------------------------------------------------------------\n");
+	printf("Flags              Size (KB)   Create p50 (us)   First touch p50 (ms)   First touch max (ms)   Steady (ms)   First/Steady   Release p50 (us)\n");
+	printf("------------------------------------------------------------------------------------------------------------------------------------------\n");
+	for (int f = 0; f < (int)(sizeof(bufferFlags) / sizeof(bufferFlags[0])); f++)
+	{
+		int copyHost = (bufferFlags[f].flags & CL_MEM_COPY_HOST_PTR) != 0;
+
+		for (size_t bytes = MINALLOCBYTES; bytes <= maxBytes; bytes *= 4)
+		{
+			double steady = DBL_MAX;
+
+			for (int r = 0; r < ALLOCREPS; r++)
+			{
+				double time = GetWallTime();
+				buffer = clCreateBuffer(*context, bufferFlags[f].flags, bytes, copyHost ? hostData : NULL, &err);
+				create[r] = GetWallTime() - time;
+				CheckOpenCLError(err, __LINE__);
+
+				first[r] = TimeInitKernel(queue, kernel, &buffer, bytes);
+				if (r == 0)
+				{
+					for (int n = 0; n < NTIMES; n++)
+					{
+						time = TimeInitKernel(queue, kernel, &buffer, bytes);
+						if (time < steady)
+						{
+							steady = time;
+						}
+					}
+				}
+#ifdef VERBOSE
+				printf("------------- %s, %zu KB: create %.2lf us, first touch %.4lf ms\n", bufferFlags[f].name, bytes / 1024, create[r] * 1.0e6, first[r] * 1.0e3);
+#endif
+
+				time = GetWallTime();
+				clReleaseMemObject(buffer);
+				release[r] = GetWallTime() - time;
+			}
+
+			double firstP50 = Percentile(first, ALLOCREPS, 50);
+			printf("%-16s %11zu   %15.2lf   %20.4lf   %20.4lf   %11.4lf   %12.2lf   %16.2lf\n", bufferFlags[f].name, bytes / 1024,
+				   Percentile(create, ALLOCREPS, 50) * 1.0e6, firstP50 * 1.0e3, Percentile(first, ALLOCREPS, 100) * 1.0e3,
+				   steady * 1.0e3, firstP50 / steady, Percentile(release, ALLOCREPS, 50) * 1.0e6);
+		}
+		printf("------------------------------------------------------------------------------------------------------------------------------------------\n");
+	}
+	printf("\n");
+
+	free(hostData);
+}
+
+// clEnqueueFillBuffer against the init kernel writing the same ones. First is the p50 of ALLOCREPS fresh default buffers,
+// GB/s is the best of NTIMES on a buffer that was already touched.
+void RunFillTests(cl_context *context, cl_command_queue *queue, cl_kernel *kernel, size_t maxBytes)
+{
+	double kernelFirst[ALLOCREPS], fillFirst[ALLOCREPS];
+	cl_mem buffer;
+	cl_int err;
+
+	printf("clEnqueueFillBuffer against initialiseDoubleArrayKernel\n");
+	printf("-----------------------------------------------------------------------------------------------------\n");
+	printf(" Size (KB)   Kernel first p50 (ms)   Fill first p50 (ms)   Kernel GB/s   Fill GB/s   Fill/Kernel\n");
+	printf("-----------------------------------------------------------------------------------------------------\n");
+	for (size_t bytes = MINALLOCBYTES; bytes <= maxBytes; bytes *= 4)
+	{
+		for (int r = 0; r < ALLOCREPS; r++)
+		{
+			buffer = clCreateBuffer(*context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+			CheckOpenCLError(err, __LINE__);
+			kernelFirst[r] = TimeInitKernel(queue, kernel, &buffer, bytes);
+			clReleaseMemObject(buffer);
+
+			buffer = clCreateBuffer(*context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+			CheckOpenCLError(err, __LINE__);
+			fillFirst[r] = TimeFillBuffer(queue, &buffer, bytes);
+			clReleaseMemObject(buffer);
+		}
+
+		// Steady state, both on the same buffer
+		double bestKernel = DBL_MAX, bestFill = DBL_MAX;
+		buffer = clCreateBuffer(*context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+		TimeInitKernel(queue, kernel, &buffer, bytes);
+		for (int n = 0; n < NTIMES; n++)
+		{
+			double time = TimeInitKernel(queue, kernel, &buffer, bytes);
+			if (time < bestKernel)
+			{
+				bestKernel = time;
+			}
+			time = TimeFillBuffer(queue, &buffer, bytes);
+			if (time < bestFill)
+			{
+				bestFill = time;
+			}
+		}
+		clReleaseMemObject(buffer);
+
+		double kernelRate = bytes / 1024.0 / 1024.0 / 1024.0 / bestKernel;
+		double fillRate = bytes / 1024.0 / 1024.0 / 1024.0 / bestFill;
+		printf("%10zu   %21.4lf   %19.4lf   %11.3lf   %9.3lf   %11.3lf\n", bytes / 1024,
+			   Percentile(kernelFirst, ALLOCREPS, 50) * 1.0e3, Percentile(fillFirst, ALLOCREPS, 50) * 1.0e3, kernelRate, fillRate, fillRate / kernelRate);
+	}
+	printf("-----------------------------------------------------------------------------------------------------\n");
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], "-I.");
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -0,0 +1,13 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Writes every element of A, as initialiseDoubleArraysKernel of the streamemory benchmark does for one array.
+// Used to touch a buffer for the first time, and compared against clEnqueueFillBuffer.
+__kernel void initialiseDoubleArrayKernel(__global double * restrict A)
+{
+	size_t tid = get_global_id(0);
+
+	A[tid] = 1.0;
+}
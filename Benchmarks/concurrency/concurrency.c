@@ -0,0 +1,681 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Independent copyKernel1 launches per run, each on its own sub-buffers of A and C
+#define NUMLAUNCHES 128
+
+// Doubles copied by every launch, small enough that one launch doesn't fill the device
+#define LAUNCHSIZES {1024, 8192, 65536}
+
+// In-order queues from 1 up to MAXQUEUES (powers of 2), launches are handed out round-robin
+#define MAXQUEUES 16
+
+// Work-items per work-group
+#define LOCALSIZE 256
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-run results during test?
+// #define VERBOSE
+
+// Start and end of a launch on the device, from its profiling event
+typedef struct
+{
+	cl_ulong start, end;
+} Interval;
+
+// Function prototypes
+double GetWallTime(void);
+int CompareIntervals(const void *a, const void *b);
+void RunConcurrencyTests(cl_context *context, cl_command_queue *queue, cl_program *program, size_t launchSize);
+double RunConcurrencyTest(cl_command_queue *queues, int numQueues, cl_kernel *kernel, cl_mem *subA, cl_mem *subC, size_t launchSize,
+						  double *concurrency, double *busy, double *averageTime);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	// Concurrency is the sum of the launch times over the time the device had at least one launch running, 1.0 means no overlap.
+	// Busy is the % of the run (first start to last end) with at least one launch running.
+	const size_t launchSizes[] = LAUNCHSIZES;
+	for (size_t s = 0; s < sizeof(launchSizes) / sizeof(launchSizes[0]); s++)
+	{
+		printf("%d launches of copyKernel1 on %zu doubles\n", NUMLAUNCHES, launchSizes[s]);
+		printf("-------------------------------------------------------------------------------------------------------\n");
+		printf("Queues             Launches/s   Rate GB/s   Speedup   Concurrency   Busy %%   Avg time   Min time\n");
+		printf("-------------------------------------------------------------------------------------------------------\n");
+		RunConcurrencyTests(&context, &queue, &program, launchSizes[s]);
+		printf("-------------------------------------------------------------------------------------------------------\n\n");
+	}
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+int CompareIntervals(const void *a, const void *b)
+{
+	const Interval *x = a, *y = b;
+	return (x->start > y->start) - (x->start < y->start);
+}
+
+// Runs NUMLAUNCHES launches of launchSize doubles over 1 to MAXQUEUES in-order queues, and over one out-of-order queue
+void RunConcurrencyTests(cl_context *context, cl_command_queue *queue, cl_program *program, size_t launchSize)
+{
+	cl_device_id device;
+	cl_uint baseAlign;
+	cl_command_queue_properties supported;
+	cl_command_queue queues[MAXQUEUES];
+	cl_mem subA[NUMLAUNCHES], subC[NUMLAUNCHES];
+	cl_kernel kernel;
+	double singleQueueTime = 0.0;
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(baseAlign), &baseAlign, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES, sizeof(supported), &supported, NULL);
+
+	kernel = clCreateKernel(*program, "copyKernel1", &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// Sub-buffers must start on the base address alignment (given in bits)
+	size_t alignBytes = baseAlign / 8;
+	size_t slotBytes = (launchSize * sizeof(cl_double) + alignBytes - 1) / alignBytes * alignBytes;
+	cl_mem A = clCreateBuffer(*context, CL_MEM_READ_ONLY, NUMLAUNCHES * slotBytes, NULL, &err);
+	cl_mem C = clCreateBuffer(*context, CL_MEM_WRITE_ONLY, NUMLAUNCHES * slotBytes, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	const cl_double one = 1.0;
+	err = clEnqueueFillBuffer(*queue, A, &one, sizeof(one), 0, NUMLAUNCHES * slotBytes, 0, NULL, NULL);
+	clFinish(*queue);
+	CheckOpenCLError(err, __LINE__);
+
+	for (int l = 0; l < NUMLAUNCHES; l++)
+	{
+		cl_buffer_region region = {l * slotBytes, launchSize * sizeof(cl_double)};
+		subA[l] = clCreateSubBuffer(A, CL_MEM_READ_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+		subC[l] = clCreateSubBuffer(C, CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+		CheckOpenCLError(err, __LINE__);
+	}
+
+	// After MAXQUEUES in-order queues, one out-of-order queue
+	for (int numQueues = 1; ; numQueues *= 2)
+	{
+		int outOfOrder = (numQueues > MAXQUEUES);
+		int queuesUsed = outOfOrder ? 1 : numQueues;
+		double concurrency, busy, averageTime;
+		char testName[64];
+
+		if (outOfOrder && !(supported & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE))
+		{
+			printf("Out-of-order queues not supported\n");
+			break;
+		}
+
+		cl_command_queue_properties properties = CL_QUEUE_PROFILING_ENABLE;
+		if (outOfOrder)
+			properties |= CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+		for (int q = 0; q < queuesUsed; q++)
+		{
+			queues[q] = clCreateCommandQueue(*context, device, properties, &err);
+			CheckOpenCLError(err, __LINE__);
+		}
+
+		double bestTime = RunConcurrencyTest(queues, queuesUsed, &kernel, subA, subC, launchSize, &concurrency, &busy, &averageTime);
+		if (numQueues == 1)
+			singleQueueTime = bestTime;
+
+		if (outOfOrder)
+			snprintf(testName, sizeof(testName), "1 out-of-order");
+		else
+			snprintf(testName, sizeof(testName), "%d in-order", numQueues);
+		printf("%-16s %12.0lf   %9.3lf   %7.2lf   %11.2lf   %6.1lf   %8.6lf   %8.6lf\n",
+			   testName, NUMLAUNCHES / bestTime, 2.0 * NUMLAUNCHES * launchSize * sizeof(cl_double) / 1024.0 / 1024.0 / 1024.0 / bestTime,
+			   singleQueueTime / bestTime, concurrency, busy, averageTime, bestTime);
+
+		for (int q = 0; q < queuesUsed; q++)
+			clReleaseCommandQueue(queues[q]);
+		if (outOfOrder)
+			break;
+	}
+
+	for (int l = 0; l < NUMLAUNCHES; l++)
+	{
+		clReleaseMemObject(subA[l]);
+		clReleaseMemObject(subC[l]);
+	}
+	clReleaseMemObject(A);
+	clReleaseMemObject(C);
+	clReleaseKernel(kernel);
+}
+
+// Times NTIMES runs of NUMLAUNCHES launches, handed round-robin to the queues, then waits for all of them.
+// Returns the best time, the concurrency and busy % of the best run come from the profiling events.
+double RunConcurrencyTest(cl_command_queue *queues, int numQueues, cl_kernel *kernel, cl_mem *subA, cl_mem *subC, size_t launchSize,
+						  double *concurrency, double *busy, double *averageTime)
+{
+	size_t globalSize = launchSize;
+	size_t localSize = (launchSize < LOCALSIZE) ? launchSize : LOCALSIZE;
+	double bestTime = DBL_MAX, totalTime = 0.0;
+	cl_event events[NUMLAUNCHES];
+	Interval intervals[NUMLAUNCHES];
+	cl_int err = CL_SUCCESS;
+
+	// First run is a warm up, every queue gets its first launch out of the way
+	for (int k = 0; k <= NTIMES; k++)
+	{
+		double time = GetWallTime();
+		for (int l = 0; l < NUMLAUNCHES; l++)
+		{
+			err |= clSetKernelArg(*kernel, 0, sizeof(cl_mem), &subA[l]);
+			err |= clSetKernelArg(*kernel, 1, sizeof(cl_mem), &subC[l]);
+			err |= clEnqueueNDRangeKernel(queues[l % numQueues], *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, &events[l]);
+		}
+		for (int q = 0; q < numQueues; q++)
+			clFlush(queues[q]);
+		for (int q = 0; q < numQueues; q++)
+			clFinish(queues[q]);
+		time = GetWallTime() - time;
+		CheckOpenCLError(err, __LINE__);
+
+		for (int l = 0; l < NUMLAUNCHES; l++)
+		{
+			clGetEventProfilingInfo(events[l], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &intervals[l].start, NULL);
+			clGetEventProfilingInfo(events[l], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &intervals[l].end, NULL);
+			clReleaseEvent(events[l]);
+		}
+
+		if (k == 0)
+			continue;
+		totalTime += time;
+
+#ifdef VERBOSE
+		printf("------------- run %2d, %8.6lf s\n", k, time);
+#endif
+
+		if (time >= bestTime)
+			continue;
+		bestTime = time;
+
+		// Union of the launch intervals, sorted by start
+		cl_ulong sum = 0, covered = 0, spanEnd = 0;
+		cl_ulong unionStart = 0, unionEnd = 0;
+		qsort(intervals, NUMLAUNCHES, sizeof(Interval), CompareIntervals);
+		for (int l = 0; l < NUMLAUNCHES; l++)
+		{
+			sum += intervals[l].end - intervals[l].start;
+			if (l == 0 || intervals[l].start > unionEnd)
+			{
+				covered += unionEnd - unionStart;
+				unionStart = intervals[l].start;
+				unionEnd = intervals[l].end;
+			}
+			else if (intervals[l].end > unionEnd)
+			{
+				unionEnd = intervals[l].end;
+			}
+			if (intervals[l].end > spanEnd)
+				spanEnd = intervals[l].end;
+		}
+		covered += unionEnd - unionStart;
+		*concurrency = covered ? (double)sum / covered : 0.0;
+		*busy = (spanEnd > intervals[0].start) ? 100.0 * covered / (spanEnd - intervals[0].start) : 0.0;
+	}
+
+	*averageTime = totalTime / NTIMES;
+	return bestTime;
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], "-I.");
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
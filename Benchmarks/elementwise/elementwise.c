@@ -25,13 +25,20 @@ const char *kernelFileName = "kernel.cl";
 // Print per-local-size results during test?
 //#define VERBOSE
 
+// Launches are reported as launch bound when the device is idle more than this fraction
+// of the timed loop. The GB/s is then the kernel launch rate rather than the memory bandwidth.
+#define IDLETHRESHOLD 0.5
+
 // Function prototypes
 double GetWallTime(void);
+int CompareDoubles(const void *a, const void *b);
 
 int main( int argc, char* argv[] )
 {
-    // Variable to store a defined size of the array
+    // Variable to store a defined size of the array, run.sh gives it as the first argument
     size_t arraySize = TRYARRAYSIZE;
+    if (argc == 2 && atol(argv[1]) > 0)
+        arraySize = (size_t)atol(argv[1]);
 
     // Host input vectors
     double *h_a;
@@ -54,7 +61,7 @@ int main( int argc, char* argv[] )
     cl_kernel kernel;                 // kernel
  
     // Size, in bytes, of each vector
-    size_t bytes = TRYARRAYSIZE * sizeof(double);
+    size_t bytes = arraySize * sizeof(double);
  
     // Allocate memory for each vector on host
     h_a = (double*)malloc(bytes);
@@ -62,7 +69,7 @@ int main( int argc, char* argv[] )
     h_out = (double*)malloc(bytes);
  
     // Initialize vectors on host
-    for( int i = 0; i < TRYARRAYSIZE; i++ ) {
+    for( size_t i = 0; i < arraySize; i++ ) {
         h_a[i] = ((double) rand() / RAND_MAX) * (5);
         h_b[i] = ((double) rand() / RAND_MAX) * (5);
         h_out[i] = 0.0;
@@ -135,11 +142,13 @@ int main( int argc, char* argv[] )
 
     err |= clSetKernelArg(kernel, (cl_uint) 4, sizeof(long), &arraySize);
 
+    cl_event events[NTIMES];
+
     double time = GetWallTime();
 
     // Execute the kernel over the entire range of the data set
     for (int n = 0; n < NTIMES; n++) {
-        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, &events[n]);
     }
 
     // Wait for the command queue to get serviced before reading back results (wait for all enqueued tasks to finish)
@@ -153,7 +162,7 @@ int main( int argc, char* argv[] )
     
 #ifdef VERBOSE
         int errFlag = 0;
-        for (int i=0; i<TRYARRAYSIZE; i++) {
+        for (size_t i=0; i<arraySize; i++) {
             if (h_out[i] != (h_a[i]*h_b[i])) {
                 //printf("Error: [%d] %f != %f \n", i, h_out[i], h_in[i]);
                 errFlag = 1;
@@ -168,7 +177,40 @@ int main( int argc, char* argv[] )
 #endif
 
     // Print measured kernel time
-    printf("GB/s: %14.3lf\n", 2*NTIMES*TRYARRAYSIZE*sizeof(double)/1024.0/1024.0/1024.0/time);
+    printf("GB/s: %14.3lf\n", 2*NTIMES*arraySize*sizeof(double)/1024.0/1024.0/1024.0/time);
+
+    // How much of the timed loop the device was running the kernel, from the profiling timestamps.
+    // Gaps are from the END of a launch to the START of the next.
+    double running = 0.0, latency = 0.0, gapSum = 0.0;
+    double gaps[NTIMES - 1];
+    cl_ulong start, end, queued, lastEnd = 0;
+    for (int n = 0; n < NTIMES; n++) {
+        err  = clGetEventProfilingInfo(events[n], CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &queued, NULL);
+        err |= clGetEventProfilingInfo(events[n], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+        err |= clGetEventProfilingInfo(events[n], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+        clReleaseEvent(events[n]);
+        if (err != CL_SUCCESS)
+            printf("Error reading the profiling info, line %d\n", __LINE__);
+
+        running += (end - start) * 1.0e-9;
+        latency += (start - queued) * 1.0e-9;
+        if (n > 0) {
+            gaps[n - 1] = start > lastEnd ? (start - lastEnd) * 1.0e-9 : 0.0;
+            gapSum += gaps[n - 1];
+        }
+        lastEnd = end;
+    }
+    qsort(gaps, NTIMES - 1, sizeof(double), CompareDoubles);
+
+    double busy = running / time;
+    printf("Kernel GB/s: %14.3lf\n", 2*NTIMES*arraySize*sizeof(double)/1024.0/1024.0/1024.0/running);
+    printf("Busy %%: %14.2lf\n", 100.0 * busy);
+    printf("Mean gap (us): %14.3lf\n", gapSum / (NTIMES - 1) * 1.0e6);
+    printf("p99 gap (us): %14.3lf\n", gaps[(NTIMES - 1) * 99 / 100] * 1.0e6);
+    printf("Queued to start (us): %14.3lf\n", latency / NTIMES * 1.0e6);
+    if (1.0 - busy > IDLETHRESHOLD)
+        printf("Launch bound: the device was idle %.2lf%% of the time, GB/s is the kernel launch rate, not the memory bandwidth\n",
+               100.0 * (1.0 - busy));
 
     // release OpenCL resources
     clReleaseMemObject(d_a);
@@ -188,6 +230,12 @@ int main( int argc, char* argv[] )
     return 0;
 }
 
+int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
 // Return ns accurate walltime
 double GetWallTime(void)
 {
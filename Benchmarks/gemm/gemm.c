@@ -0,0 +1,757 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Square matrix sizes tested, must be multiples of TS, TSM, TSN and TSK.
+// A single size can be given as the first argument.
+#define GEMMSIZES {256, 512, 1024, 2048}
+
+// Default tile parameters, see kernels.cl. They can be overridden from the command line, so an
+// auto-tuning search can explore them without recompiling: ./gemm.out size TS TSM TSN TSK WPTM WPTN WIDTH
+#define TS 16
+#define TSM 64
+#define TSN 64
+#define TSK 16
+#define WPTM 4
+#define WPTN 4
+#define WIDTH 4
+
+// Block size of the host reference
+#define HOSTBLOCK 64
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-launch results during test?
+// #define VERBOSE
+
+// Tile parameters, passed to kernels.cl with -D and used for the launch geometry
+typedef struct
+{
+	int ts, tsm, tsn, tsk, wptm, wptn, width;
+} GemmParams;
+
+GemmParams params = {TS, TSM, TSN, TSK, WPTM, WPTN, WIDTH};
+
+// Built by InitialiseCLEnvironment from params
+char buildOptions[256] = "-I.";
+
+// Function prototypes
+double GetWallTime(void);
+int CheckParams(GemmParams *p, size_t maxWorkGroupSize);
+void HostGemm(const double *A, const double *B, double *C, size_t n);
+void RunGemmTests(cl_context *context, cl_command_queue *queue, cl_program *program, size_t n);
+void RunGemmTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, size_t n, const size_t *globalSize, const size_t *localSize,
+				 size_t dataType, cl_mem *C, const double *reference);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(int argc, char *argv[])
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_device_id      device;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+	size_t            maxWorkGroupSize;
+
+	// ./gemm.out [size [TS TSM TSN TSK WPTM WPTN WIDTH]]
+	size_t userSize = 0;
+	if (argc >= 2)
+		userSize = (size_t)atoi(argv[1]);
+	if (argc == 9)
+	{
+		params.ts = atoi(argv[2]);
+		params.tsm = atoi(argv[3]);
+		params.tsn = atoi(argv[4]);
+		params.tsk = atoi(argv[5]);
+		params.wptm = atoi(argv[6]);
+		params.wptn = atoi(argv[7]);
+		params.width = atoi(argv[8]);
+	}
+	else if (argc > 2)
+	{
+		printf("Usage: %s [size [TS TSM TSN TSK WPTM WPTN WIDTH]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -DTS=%d -DTSM=%d -DTSN=%d -DTSK=%d -DWPTM=%d -DWPTN=%d -DWIDTH=%d",
+			 params.ts, params.tsm, params.tsn, params.tsk, params.wptm, params.wptn, params.width);
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+
+	if (CheckParams(&params, maxWorkGroupSize) == EXIT_FAILURE)
+	{
+		CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+		return EXIT_FAILURE;
+	}
+
+	const size_t sizes[] = GEMMSIZES;
+	int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+	printf("Tiles: %s\n", buildOptions);
+	printf("-------------------------------------------------------------------------------------------\n");
+	printf("Function               Size   Best GFLOPS   Avg time   Min time   Max time   Workgroup Size\n");
+	printf("-------------------------------------------------------------------------------------------\n");
+	for (int s = 0; s < numSizes; s++)
+	{
+		size_t n = userSize ? userSize : sizes[s];
+		int lcm = params.tsm > params.tsn ? params.tsm : params.tsn;
+		if (n % params.ts != 0 || n % params.tsm != 0 || n % params.tsn != 0 || n % params.tsk != 0 || n % lcm != 0)
+		{
+			printf("Size %zu is not a multiple of the tiles, skipping\n", n);
+		}
+		else if (n * n * sizeof(double) > maxAlloc || 3 * n * n * sizeof(double) > globalMemSize)
+		{
+			printf("Size %zu does not fit in device memory, skipping\n", n);
+		}
+		else
+		{
+			RunGemmTests(&context, &queue, &program, n);
+		}
+
+		if (userSize)
+			break;
+	}
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Returns EXIT_FAILURE, and says why, when the tiles can't be used by the kernels
+int CheckParams(GemmParams *p, size_t maxWorkGroupSize)
+{
+	if (p->ts <= 0 || p->tsm <= 0 || p->tsn <= 0 || p->tsk <= 0 || p->wptm <= 0 || p->wptn <= 0)
+	{
+		printf("Tile parameters must be positive\n");
+		return EXIT_FAILURE;
+	}
+	if (p->width != 2 && p->width != 4 && p->width != 8 && p->width != 16)
+	{
+		printf("WIDTH must be 2, 4, 8 or 16\n");
+		return EXIT_FAILURE;
+	}
+	if (p->tsm % p->wptm != 0 || p->tsn % p->wptn != 0)
+	{
+		printf("TSM must be a multiple of WPTM and TSN a multiple of WPTN\n");
+		return EXIT_FAILURE;
+	}
+	if (p->tsk % p->width != 0 || p->tsn % p->width != 0)
+	{
+		printf("TSK and TSN must be multiples of WIDTH\n");
+		return EXIT_FAILURE;
+	}
+	if ((size_t)(p->ts * p->ts) > maxWorkGroupSize || (size_t)((p->tsm / p->wptm) * (p->tsn / p->wptn)) > maxWorkGroupSize)
+	{
+		printf("TS x TS and (TSM / WPTM) x (TSN / WPTN) must not go over the max work-group size, %zu\n", maxWorkGroupSize);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+// Blocked C = A * B on the host, the reference for both precisions
+void HostGemm(const double *A, const double *B, double *C, size_t n)
+{
+	memset(C, 0, n * n * sizeof(double));
+	for (size_t ii = 0; ii < n; ii += HOSTBLOCK)
+		for (size_t kk = 0; kk < n; kk += HOSTBLOCK)
+			for (size_t jj = 0; jj < n; jj += HOSTBLOCK)
+				for (size_t i = ii; i < ii + HOSTBLOCK && i < n; i++)
+					for (size_t k = kk; k < kk + HOSTBLOCK && k < n; k++)
+					{
+						double a = A[i * n + k];
+						for (size_t j = jj; j < jj + HOSTBLOCK && j < n; j++)
+							C[i * n + j] += a * B[k * n + j];
+					}
+}
+
+// Runs the naive, tiled and register-blocked kernels on n x n matrices, DGEMM then SGEMM
+void RunGemmTests(cl_context *context, cl_command_queue *queue, cl_program *program, size_t n)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const char *prefixes[] = {"dgemm", "sgemm"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const char *variants[] = {"Naive", "Tiled", "RegBlock"};
+	cl_uint size = n;
+	char kernelName[64];
+	char testName[64];
+	cl_kernel kernel;
+	cl_int err;
+
+	// Inputs are floats in [0, 1), so both precisions multiply exactly the same values
+	double *A = malloc(n * n * sizeof(double));
+	double *B = malloc(n * n * sizeof(double));
+	double *reference = malloc(n * n * sizeof(double));
+	srand(0);
+	for (size_t i = 0; i < n * n; i++)
+	{
+		A[i] = (float)rand() / RAND_MAX;
+		B[i] = (float)rand() / RAND_MAX;
+	}
+	HostGemm(A, B, reference, n);
+
+	for (int p = 0; p < 2; p++)
+	{
+		size_t sizeBytes = n * n * typeSizes[p];
+		void *hostA = malloc(sizeBytes);
+		void *hostB = malloc(sizeBytes);
+		for (size_t i = 0; i < n * n; i++)
+		{
+			if (p == 0)
+			{
+				((double *)hostA)[i] = A[i];
+				((double *)hostB)[i] = B[i];
+			}
+			else
+			{
+				((float *)hostA)[i] = (float)A[i];
+				((float *)hostB)[i] = (float)B[i];
+			}
+		}
+
+		cl_mem bufferA = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeBytes, hostA, &err);
+		cl_mem bufferB = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeBytes, hostB, &err);
+		cl_mem bufferC = clCreateBuffer(*context, CL_MEM_WRITE_ONLY, sizeBytes, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+
+		for (int v = 0; v < 3; v++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "gemm%s%s", variants[v], precisions[p]);
+			snprintf(testName, sizeof(testName), "%s%s", prefixes[p], variants[v]);
+			kernel = clCreateKernel(*program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+			err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &bufferA);
+			err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &bufferB);
+			err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &bufferC);
+			err |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &size);
+			err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &size);
+			err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &size);
+			CheckOpenCLError(err, __LINE__);
+
+			// Naive and tiled have one work-item per element of C, register-blocked WPTM x WPTN
+			size_t globalSize[2] = {n, n};
+			size_t localSize[2] = {params.ts, params.ts};
+			if (v == 2)
+			{
+				globalSize[0] = n / params.wptn;
+				globalSize[1] = n / params.wptm;
+				localSize[0] = params.tsn / params.wptn;
+				localSize[1] = params.tsm / params.wptm;
+			}
+
+			RunGemmTest(queue, &kernel, testName, n, globalSize, localSize, typeSizes[p], &bufferC, reference);
+			clReleaseKernel(kernel);
+		}
+		printf("-------------------------------------------------------------------------------------------\n");
+
+		clReleaseMemObject(bufferA);
+		clReleaseMemObject(bufferB);
+		clReleaseMemObject(bufferC);
+		free(hostA);
+		free(hostB);
+	}
+
+	free(A);
+	free(B);
+	free(reference);
+}
+
+// Times NTIMES launches one by one. C is checked against the host reference after the first one.
+void RunGemmTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, size_t n, const size_t *globalSize, const size_t *localSize,
+				 size_t dataType, cl_mem *C, const double *reference)
+{
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	cl_int err;
+
+	err = clEnqueueNDRangeKernel(*queue, *kernel, 2, NULL, globalSize, localSize, 0, NULL, NULL);
+	CheckOpenCLError(err, __LINE__);
+
+	// Every element adds n positive products, the float error grows with n
+	double epsilon = (dataType == sizeof(double)) ? 1e-12 : 1e-6 * n;
+	void *result = malloc(n * n * dataType);
+	clEnqueueReadBuffer(*queue, *C, CL_TRUE, 0, n * n * dataType, result, 0, NULL, NULL);
+	for (size_t i = 0; i < n * n; i++)
+	{
+		double r = (dataType == sizeof(double)) ? ((double *)result)[i] : ((float *)result)[i];
+		if (fabs(r - reference[i]) > epsilon * fabs(reference[i]))
+		{
+			printf("Error in %s, C[%zu][%zu] is %e, expected %e\n", testName, i / n, i % n, r, reference[i]);
+			break;
+		}
+	}
+	free(result);
+
+	for (int t = 0; t < NTIMES; t++)
+	{
+		double time = GetWallTime();
+		err = clEnqueueNDRangeKernel(*queue, *kernel, 2, NULL, globalSize, localSize, 0, NULL, NULL);
+		clFinish(*queue);
+		time = GetWallTime() - time;
+		CheckOpenCLError(err, __LINE__);
+
+		if (time < bestTime)
+		{
+			bestTime = time;
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+
+#ifdef VERBOSE
+		printf("------------- launch %2d, %9.3lf GFLOPS\n", t, 2.0 * n * n * n / 1.0e9 / time);
+#endif
+	}
+
+	printf("%-16s   %8zu   %11.3lf   %8.6lf   %8.6lf   %8.6lf   %9zux%-4zu\n",
+		   testName, n, 2.0 * n * n * n / 1.0e9 / bestTime, totalTime / NTIMES, bestTime, worstTime, localSize[0], localSize[1]);
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program with the tile parameters
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
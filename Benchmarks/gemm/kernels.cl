@@ -0,0 +1,153 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Tile parameters, set by the host with -D:
+// TS                 tile side of gemmTiled, TS x TS work-groups
+// TSM, TSN, TSK      tile of C (TSM x TSN) and depth of K (TSK) of gemmRegBlock per work-group
+// WPTM, WPTN         elements of C per work-item in gemmRegBlock, (TSN / WPTN) x (TSM / WPTM) work-groups
+// WIDTH              vector width of the gemmRegBlock loads, 2, 4, 8 or 16
+#ifndef TS
+#define TS 16
+#endif
+#ifndef TSM
+#define TSM 64
+#endif
+#ifndef TSN
+#define TSN 64
+#endif
+#ifndef TSK
+#define TSK 16
+#endif
+#ifndef WPTM
+#define WPTM 4
+#endif
+#ifndef WPTN
+#define WPTN 4
+#endif
+#ifndef WIDTH
+#define WIDTH 4
+#endif
+
+// Work-items per work-group in each dimension of gemmRegBlock
+#define RTSM (TSM / WPTM)
+#define RTSN (TSN / WPTN)
+
+#define CONCAT_(a, b) a##b
+#define CONCAT(a, b) CONCAT_(a, b)
+#define VLOAD CONCAT(vload, WIDTH)
+#define VSTORE CONCAT(vstore, WIDTH)
+
+// C = A * B, row major, A is M x K, B is K x N and C is M x N.
+// Sizes must be multiples of the tiles.
+#define GEMM_KERNELS(TYPENAME, TYPE)                                                        \
+                                                                                           \
+/* One element of C per work-item, straight from global memory */                          \
+__kernel void gemmNaive##TYPENAME(__global const TYPE * restrict A,                        \
+                                  __global const TYPE * restrict B,                        \
+                                  __global TYPE * restrict C,                              \
+                                  const uint M,                                            \
+                                  const uint N,                                            \
+                                  const uint K)                                            \
+{                                                                                          \
+	size_t col = get_global_id(0);                                                         \
+	size_t row = get_global_id(1);                                                         \
+	TYPE acc = 0;                                                                          \
+                                                                                           \
+	for (uint k = 0; k < K; k++)                                                           \
+		acc += A[row * K + k] * B[(size_t)k * N + col];                                    \
+	C[row * N + col] = acc;                                                                \
+}                                                                                          \
+                                                                                           \
+/* One element of C per work-item, TS x TS tiles of A and B go through local memory */     \
+__kernel void gemmTiled##TYPENAME(__global const TYPE * restrict A,                        \
+                                  __global const TYPE * restrict B,                        \
+                                  __global TYPE * restrict C,                              \
+                                  const uint M,                                            \
+                                  const uint N,                                            \
+                                  const uint K)                                            \
+{                                                                                          \
+	__local TYPE Asub[TS][TS];                                                             \
+	__local TYPE Bsub[TS][TS];                                                             \
+	int lcol = get_local_id(0);                                                            \
+	int lrow = get_local_id(1);                                                            \
+	size_t col = get_global_id(0);                                                         \
+	size_t row = get_global_id(1);                                                         \
+	TYPE acc = 0;                                                                          \
+                                                                                           \
+	for (uint t = 0; t < K; t += TS)                                                       \
+	{                                                                                      \
+		Asub[lrow][lcol] = A[row * K + t + lcol];                                          \
+		Bsub[lrow][lcol] = B[(size_t)(t + lrow) * N + col];                                \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+                                                                                           \
+		for (int k = 0; k < TS; k++)                                                       \
+			acc += Asub[lrow][k] * Bsub[k][lcol];                                          \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+	}                                                                                      \
+	C[row * N + col] = acc;                                                                \
+}                                                                                          \
+                                                                                           \
+/* WPTM x WPTN elements of C per work-item, accumulated in registers. TSM x TSK and        \
+   TSK x TSN tiles of A and B are loaded into local memory with WIDTH vector loads. */     \
+__kernel void gemmRegBlock##TYPENAME(__global const TYPE * restrict A,                     \
+                                     __global const TYPE * restrict B,                     \
+                                     __global TYPE * restrict C,                           \
+                                     const uint M,                                         \
+                                     const uint N,                                         \
+                                     const uint K)                                         \
+{                                                                                          \
+	__local TYPE Asub[TSM][TSK];                                                           \
+	__local TYPE Bsub[TSK][TSN];                                                           \
+	int tidn = get_local_id(0);                                                            \
+	int tidm = get_local_id(1);                                                            \
+	int tid = tidm * RTSN + tidn;                                                          \
+	size_t offsetM = (size_t)TSM * get_group_id(1);                                        \
+	size_t offsetN = (size_t)TSN * get_group_id(0);                                        \
+	TYPE acc[WPTM][WPTN];                                                                  \
+	TYPE Breg[WPTN];                                                                       \
+                                                                                           \
+	for (int wm = 0; wm < WPTM; wm++)                                                      \
+		for (int wn = 0; wn < WPTN; wn++)                                                  \
+			acc[wm][wn] = 0;                                                               \
+                                                                                           \
+	for (uint t = 0; t < K; t += TSK)                                                      \
+	{                                                                                      \
+		for (int v = tid; v < TSM * TSK / WIDTH; v += RTSM * RTSN)                         \
+		{                                                                                  \
+			int row = v / (TSK / WIDTH);                                                   \
+			int col = (v % (TSK / WIDTH)) * WIDTH;                                         \
+			VSTORE(VLOAD(0, A + (offsetM + row) * K + t + col), 0, &Asub[row][col]);       \
+		}                                                                                  \
+		for (int v = tid; v < TSK * TSN / WIDTH; v += RTSM * RTSN)                         \
+		{                                                                                  \
+			int row = v / (TSN / WIDTH);                                                   \
+			int col = (v % (TSN / WIDTH)) * WIDTH;                                         \
+			VSTORE(VLOAD(0, B + (size_t)(t + row) * N + offsetN + col), 0, &Bsub[row][col]); \
+		}                                                                                  \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+                                                                                           \
+		for (int k = 0; k < TSK; k++)                                                      \
+		{                                                                                  \
+			for (int wn = 0; wn < WPTN; wn++)                                              \
+				Breg[wn] = Bsub[k][tidn + wn * RTSN];                                      \
+			for (int wm = 0; wm < WPTM; wm++)                                              \
+			{                                                                              \
+				TYPE Areg = Asub[tidm + wm * RTSM][k];                                     \
+				for (int wn = 0; wn < WPTN; wn++)                                          \
+					acc[wm][wn] += Areg * Breg[wn];                                        \
+			}                                                                              \
+		}                                                                                  \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+	}                                                                                      \
+                                                                                           \
+	/* Work-items next to each other write elements of C next to each other */             \
+	for (int wm = 0; wm < WPTM; wm++)                                                      \
+		for (int wn = 0; wn < WPTN; wn++)                                                  \
+			C[(offsetM + tidm + wm * RTSM) * N + offsetN + tidn + wn * RTSN] = acc[wm][wn]; \
+}
+
+// gemmNaiveDouble, gemmTiledDouble, gemmRegBlockDouble (DGEMM), gemmNaiveFloat, ... (SGEMM)
+GEMM_KERNELS(Double, double)
+GEMM_KERNELS(Float, float)
@@ -0,0 +1,703 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Elements per histogram
+#define HISTSIZE (16 * 1024 * 1024)
+
+// Bins from MINBINS to MAXBINS, BINSSTEP times more every time
+#define MINBINS 16
+#define MAXBINS (64 * 1024)
+#define BINSSTEP 4
+
+// Work-items per work-group, and work-groups per compute unit. The kernels loop over the input,
+// so every work-group merges its local histograms once.
+#define LOCALSIZE 256
+#define GROUPSPERCU 4
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-run results during test?
+// #define VERBOSE
+
+// Input distributions
+enum { UNIFORM, ZIPF, SINGLE, NUMINPUTS };
+const char *inputNames[NUMINPUTS] = {"uniform", "zipf", "single"};
+
+// Function prototypes
+double GetWallTime(void);
+void GenerateInput(cl_uint *in, size_t n, cl_uint bins, int input);
+void RunHistogramTests(cl_context *context, cl_command_queue *queue, cl_program *program);
+void RunHistogramTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, const char *inputName, cl_uint bins, cl_uint copies,
+					  size_t globalSize, cl_mem *histogram, const cl_uint *reference);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	RunHistogramTests(&context, &queue, &program);
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Fills in with n bin indices in [0, bins):
+// - uniform -> Every bin equally likely.
+// - zipf -> Bin k with probability proportional to 1 / (k + 1), bin 0 is the hottest.
+// - single -> Every element in bin 0, all of them collide.
+void GenerateInput(cl_uint *in, size_t n, cl_uint bins, int input)
+{
+	// rand() may only give 15 bits, so two calls are combined
+	srand(bins);
+	if (input == UNIFORM)
+	{
+		for (size_t i = 0; i < n; i++)
+			in[i] = (cl_uint)((((size_t)rand() << 15) ^ (size_t)rand()) % bins);
+	}
+	else if (input == ZIPF)
+	{
+		// Inverse of the cumulative distribution, with a binary search
+		double *cdf = malloc(bins * sizeof(double));
+		double sum = 0.0;
+		for (cl_uint k = 0; k < bins; k++)
+		{
+			sum += 1.0 / (k + 1);
+			cdf[k] = sum;
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			double u = sum * (double)(((size_t)rand() << 15) ^ (size_t)rand()) / ((double)((size_t)RAND_MAX << 15 | RAND_MAX) + 1.0);
+			cl_uint lo = 0, hi = bins - 1;
+			while (lo < hi)
+			{
+				cl_uint mid = (lo + hi) / 2;
+				if (cdf[mid] < u)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			in[i] = lo;
+		}
+		free(cdf);
+	}
+	else
+	{
+		memset(in, 0, n * sizeof(cl_uint));
+	}
+}
+
+// Runs the three strategies on every input and number of bins. Local histograms are skipped when they don't fit
+// in local memory, privatised ones get as many copies as sub-groups per work-group, or as fit.
+void RunHistogramTests(cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	cl_device_id device;
+	cl_uint computeUnits;
+	cl_ulong localMemSize;
+	size_t subGroupSize;
+	cl_kernel globalKernel, localKernel, privateKernel;
+	cl_uint n = HISTSIZE;
+	char testName[64];
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(computeUnits), &computeUnits, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize), &localMemSize, NULL);
+
+	globalKernel = clCreateKernel(*program, "histogramGlobal", &err);
+	localKernel = clCreateKernel(*program, "histogramLocal", &err);
+	privateKernel = clCreateKernel(*program, "histogramPrivate", &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// The wavefront (warp) size stands for the sub-group size
+	clGetKernelWorkGroupInfo(privateKernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(subGroupSize), &subGroupSize, NULL);
+	if (subGroupSize == 0 || subGroupSize > LOCALSIZE)
+		subGroupSize = LOCALSIZE;
+
+	cl_uint *in = malloc(n * sizeof(cl_uint));
+	cl_uint *reference = malloc(MAXBINS * sizeof(cl_uint));
+	cl_mem inBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY, n * sizeof(cl_uint), NULL, &err);
+	cl_mem histogram = clCreateBuffer(*context, CL_MEM_READ_WRITE, MAXBINS * sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	size_t globalSize = (size_t)computeUnits * GROUPSPERCU * LOCALSIZE;
+
+	printf("Elements: %u, work-groups: %u x %d of %d work-items, sub-group size: %zu, local memory: %llu bytes\n",
+		   n, computeUnits, GROUPSPERCU, LOCALSIZE, subGroupSize, (unsigned long long)localMemSize);
+	printf("------------------------------------------------------------------------------------------------\n");
+	printf("Function         Input        Bins   Copies   Best Gelem/s   Avg time   Min time   Max time\n");
+	printf("------------------------------------------------------------------------------------------------\n");
+
+	for (int input = 0; input < NUMINPUTS; input++)
+	{
+		for (cl_uint bins = MINBINS; bins <= MAXBINS; bins *= BINSSTEP)
+		{
+			GenerateInput(in, n, bins, input);
+			memset(reference, 0, bins * sizeof(cl_uint));
+			for (size_t i = 0; i < n; i++)
+				reference[in[i]]++;
+			err = clEnqueueWriteBuffer(*queue, inBuffer, CL_TRUE, 0, n * sizeof(cl_uint), in, 0, NULL, NULL);
+			CheckOpenCLError(err, __LINE__);
+
+			err = clSetKernelArg(globalKernel, 0, sizeof(cl_mem), &inBuffer);
+			err |= clSetKernelArg(globalKernel, 1, sizeof(cl_mem), &histogram);
+			err |= clSetKernelArg(globalKernel, 2, sizeof(cl_uint), &n);
+			CheckOpenCLError(err, __LINE__);
+			snprintf(testName, sizeof(testName), "global");
+			RunHistogramTest(queue, &globalKernel, testName, inputNames[input], bins, 0, globalSize, &histogram, reference);
+
+			if (bins * sizeof(cl_uint) <= localMemSize)
+			{
+				err = clSetKernelArg(localKernel, 0, sizeof(cl_mem), &inBuffer);
+				err |= clSetKernelArg(localKernel, 1, sizeof(cl_mem), &histogram);
+				err |= clSetKernelArg(localKernel, 2, sizeof(cl_uint), &n);
+				err |= clSetKernelArg(localKernel, 3, sizeof(cl_uint), &bins);
+				err |= clSetKernelArg(localKernel, 4, bins * sizeof(cl_uint), NULL);
+				CheckOpenCLError(err, __LINE__);
+				snprintf(testName, sizeof(testName), "local");
+				RunHistogramTest(queue, &localKernel, testName, inputNames[input], bins, 1, globalSize, &histogram, reference);
+			}
+
+			// Halve the copies until they fit, one copy is the local histogram again
+			cl_uint copies = LOCALSIZE / subGroupSize;
+			while (copies > 1 && copies * bins * sizeof(cl_uint) > localMemSize)
+				copies /= 2;
+			if (copies > 1)
+			{
+				err = clSetKernelArg(privateKernel, 0, sizeof(cl_mem), &inBuffer);
+				err |= clSetKernelArg(privateKernel, 1, sizeof(cl_mem), &histogram);
+				err |= clSetKernelArg(privateKernel, 2, sizeof(cl_uint), &n);
+				err |= clSetKernelArg(privateKernel, 3, sizeof(cl_uint), &bins);
+				err |= clSetKernelArg(privateKernel, 4, sizeof(cl_uint), &copies);
+				err |= clSetKernelArg(privateKernel, 5, copies * bins * sizeof(cl_uint), NULL);
+				CheckOpenCLError(err, __LINE__);
+				snprintf(testName, sizeof(testName), "private");
+				RunHistogramTest(queue, &privateKernel, testName, inputNames[input], bins, copies, globalSize, &histogram, reference);
+			}
+		}
+		printf("------------------------------------------------------------------------------------------------\n");
+	}
+
+	clReleaseMemObject(inBuffer);
+	clReleaseMemObject(histogram);
+	clReleaseKernel(globalKernel);
+	clReleaseKernel(localKernel);
+	clReleaseKernel(privateKernel);
+	free(in);
+	free(reference);
+}
+
+// Times NTIMES runs of a histogram kernel, the histogram is zeroed before every run, outside of the timing.
+// The first run is checked against the host histogram, and its total against the number of elements.
+void RunHistogramTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, const char *inputName, cl_uint bins, cl_uint copies,
+					  size_t globalSize, cl_mem *histogram, const cl_uint *reference)
+{
+	const cl_uint zero = 0;
+	size_t localSize = LOCALSIZE;
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	cl_uint *result = malloc(bins * sizeof(cl_uint));
+	cl_int err;
+
+	for (int k = 0; k <= NTIMES; k++)
+	{
+		err = clEnqueueFillBuffer(*queue, *histogram, &zero, sizeof(zero), 0, bins * sizeof(cl_uint), 0, NULL, NULL);
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		double time = GetWallTime();
+		err = clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+		clFinish(*queue);
+		time = GetWallTime() - time;
+		CheckOpenCLError(err, __LINE__);
+
+		if (k == 0)
+		{
+			size_t total = 0;
+			clEnqueueReadBuffer(*queue, *histogram, CL_TRUE, 0, bins * sizeof(cl_uint), result, 0, NULL, NULL);
+			for (cl_uint b = 0; b < bins; b++)
+			{
+				total += result[b];
+				if (result[b] != reference[b])
+				{
+					printf("Error in %s (%s, %u bins), bin %u is %u, expected %u\n", testName, inputName, bins, b, result[b], reference[b]);
+					break;
+				}
+			}
+			if (total != HISTSIZE)
+				printf("Error in %s (%s, %u bins), total is %zu, expected %d\n", testName, inputName, bins, total, HISTSIZE);
+			continue;
+		}
+
+		if (time < bestTime)
+		{
+			bestTime = time;
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+
+#ifdef VERBOSE
+		printf("------------- %s run %2d, %9.3lf Gelem/s\n", testName, k, HISTSIZE / 1.0e9 / time);
+#endif
+	}
+
+	printf("%-16s %-8s %8u   %6u   %12.3lf   %8.6lf   %8.6lf   %8.6lf\n",
+		   testName, inputName, bins, copies, HISTSIZE / 1.0e9 / bestTime, totalTime / NTIMES, bestTime, worstTime);
+	free(result);
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], "-I.");
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
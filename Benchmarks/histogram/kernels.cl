@@ -0,0 +1,65 @@
+// Histograms of n bin indices (every element of in is already in [0, bins)).
+// All the kernels go over the input with a grid-stride loop, so a small grid can cover any n
+// and the local histograms are merged once per work-group.
+
+// Every element is an atomic increment of its bin in global memory
+__kernel void histogramGlobal(__global const uint * restrict in, __global uint * restrict histogram, const uint n)
+{
+	for (size_t i = get_global_id(0); i < n; i += get_global_size(0))
+		atomic_inc(&histogram[in[i]]);
+}
+
+// One histogram of bins counters per work-group in local memory, added to the global one at the end
+__kernel void histogramLocal(__global const uint * restrict in,
+                             __global uint * restrict histogram,
+                             const uint n,
+                             const uint bins,
+                             __local uint *localHistogram)
+{
+	uint lid = get_local_id(0);
+	uint localSize = get_local_size(0);
+
+	for (uint b = lid; b < bins; b += localSize)
+		localHistogram[b] = 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for (size_t i = get_global_id(0); i < n; i += get_global_size(0))
+		atomic_inc(&localHistogram[in[i]]);
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for (uint b = lid; b < bins; b += localSize)
+		if (localHistogram[b])
+			atomic_add(&histogram[b], localHistogram[b]);
+}
+
+// copies histograms per work-group in local memory, copy c used by work-items c * localSize / copies up to
+// (c + 1) * localSize / copies. With copies = localSize / wavefront size, every sub-group (wavefront, warp)
+// has its own, and only its own work-items collide on hot bins. Copies are added up at the end.
+__kernel void histogramPrivate(__global const uint * restrict in,
+                               __global uint * restrict histogram,
+                               const uint n,
+                               const uint bins,
+                               const uint copies,
+                               __local uint *localHistograms)
+{
+	uint lid = get_local_id(0);
+	uint localSize = get_local_size(0);
+	__local uint *myHistogram = localHistograms + (lid * copies / localSize) * bins;
+
+	for (uint b = lid; b < bins * copies; b += localSize)
+		localHistograms[b] = 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for (size_t i = get_global_id(0); i < n; i += get_global_size(0))
+		atomic_inc(&myHistogram[in[i]]);
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for (uint b = lid; b < bins; b += localSize)
+	{
+		uint sum = 0;
+		for (uint c = 0; c < copies; c++)
+			sum += localHistograms[c * bins + b];
+		if (sum)
+			atomic_add(&histogram[b], sum);
+	}
+}
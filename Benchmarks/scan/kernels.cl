@@ -0,0 +1,326 @@
+// Work-items per work-group, a power of 2. Set by the host with -D.
+#ifndef WG_SIZE
+#define WG_SIZE 256
+#endif
+
+// Consecutive elements per work-item in the tiles of the reduce-scan-propagate and look-back scans
+#ifndef ITEMS
+#define ITEMS 8
+#endif
+
+#define TILE (WG_SIZE * ITEMS)
+
+// Status of a tile in the look-back scan
+#define FLAG_INVALID 0
+#define FLAG_AGGREGATE 1
+#define FLAG_PREFIX 2
+
+// Scans of uint (32-bit) and ulong (64-bit) keys, wrapping around on overflow like the host reference.
+// With inclusive set, element i of the output includes element i of the input.
+#define SCAN_KERNELS(TYPENAME, TYPE)                                                       \
+                                                                                           \
+/* Blelloch exclusive scan of n elements (a power of 2) of temp, in place,                 \
+   by the whole work-group. Returns the total */                                           \
+TYPE WorkGroupScan##TYPENAME(__local TYPE *temp, uint n)                                   \
+{                                                                                          \
+	uint lid = get_local_id(0);                                                            \
+	uint offset = 1;                                                                       \
+	TYPE total;                                                                            \
+                                                                                           \
+	/* Up-sweep, builds the sums of the tree in place */                                   \
+	for (uint d = n >> 1; d > 0; d >>= 1, offset <<= 1)                                    \
+	{                                                                                      \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+		for (uint i = lid; i < d; i += WG_SIZE)                                            \
+			temp[offset * (2 * i + 2) - 1] += temp[offset * (2 * i + 1) - 1];              \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	total = temp[n - 1];                                                                   \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	if (lid == 0)                                                                          \
+		temp[n - 1] = 0;                                                                   \
+                                                                                           \
+	/* Down-sweep, pushes the prefixes back down the tree */                               \
+	for (uint d = 1; d < n; d <<= 1)                                                       \
+	{                                                                                      \
+		offset >>= 1;                                                                      \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+		for (uint i = lid; i < d; i += WG_SIZE)                                            \
+		{                                                                                  \
+			uint ai = offset * (2 * i + 1) - 1;                                            \
+			uint bi = offset * (2 * i + 2) - 1;                                            \
+			TYPE t = temp[ai];                                                             \
+			temp[ai] = temp[bi];                                                           \
+			temp[bi] += t;                                                                 \
+		}                                                                                  \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	return total;                                                                          \
+}                                                                                          \
+                                                                                           \
+/* Loads a TILE of in starting at base through local memory, every work-item               \
+   scans its ITEMS consecutive elements into items and the work-group scans                \
+   the work-item totals. Returns the tile total, the exclusive prefix of the               \
+   work-item within the tile goes to threadPrefix */                                       \
+TYPE LoadTile##TYPENAME(__global const TYPE *in, size_t base, uint n,                      \
+                        __local TYPE *tile, __local TYPE *sums,                            \
+                        TYPE *items, TYPE *threadPrefix, uint inclusive)                   \
+{                                                                                          \
+	uint lid = get_local_id(0);                                                            \
+	TYPE sum = 0;                                                                          \
+	TYPE total;                                                                            \
+                                                                                           \
+	/* Coalesced load, out of range elements are 0 */                                      \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		size_t i = base + lid + k * WG_SIZE;                                               \
+		tile[lid + k * WG_SIZE] = (i < n) ? in[i] : 0;                                     \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		TYPE value = tile[lid * ITEMS + k];                                                \
+		items[k] = inclusive ? sum + value : sum;                                          \
+		sum += value;                                                                      \
+	}                                                                                      \
+	sums[lid] = sum;                                                                       \
+	total = WorkGroupScan##TYPENAME(sums, WG_SIZE);                                        \
+	*threadPrefix = sums[lid];                                                             \
+	return total;                                                                          \
+}                                                                                          \
+                                                                                           \
+/* Adds prefix to the items of every work-item and stores the tile,                        \
+   coalesced, through local memory */                                                      \
+void StoreTile##TYPENAME(__global TYPE *out, size_t base, uint n,                          \
+                         __local TYPE *tile, TYPE *items, TYPE prefix)                     \
+{                                                                                          \
+	uint lid = get_local_id(0);                                                            \
+                                                                                           \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+		tile[lid * ITEMS + k] = items[k] + prefix;                                         \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		size_t i = base + lid + k * WG_SIZE;                                               \
+		if (i < n)                                                                         \
+			out[i] = tile[lid + k * WG_SIZE];                                              \
+	}                                                                                      \
+}                                                                                          \
+                                                                                           \
+/* Baseline, every scan reads and writes each element once, like a copy */                 \
+__kernel void copyKernel##TYPENAME(__global const TYPE * restrict in,                      \
+                                   __global TYPE * restrict out,                           \
+                                   const uint n)                                           \
+{                                                                                          \
+	size_t i = get_global_id(0);                                                           \
+	if (i < n)                                                                             \
+		out[i] = in[i];                                                                    \
+}                                                                                          \
+                                                                                           \
+/* Scan-then-propagate, blocks of 2 * WG_SIZE elements are scanned in local                \
+   memory, the block totals go to blockSums. in and out can be the same buffer */          \
+__kernel void blellochScan##TYPENAME(__global const TYPE *in,                              \
+                                     __global TYPE *out,                                   \
+                                     __global TYPE *blockSums,                             \
+                                     const uint n,                                         \
+                                     const uint inclusive)                                 \
+{                                                                                          \
+	__local TYPE temp[2 * WG_SIZE];                                                        \
+	uint lid = get_local_id(0);                                                            \
+	size_t base = get_group_id(0) * 2 * WG_SIZE;                                           \
+	size_t i0 = base + lid;                                                                \
+	size_t i1 = base + lid + WG_SIZE;                                                      \
+	TYPE v0 = (i0 < n) ? in[i0] : 0;                                                       \
+	TYPE v1 = (i1 < n) ? in[i1] : 0;                                                       \
+	TYPE total;                                                                            \
+                                                                                           \
+	temp[lid] = v0;                                                                        \
+	temp[lid + WG_SIZE] = v1;                                                              \
+	total = WorkGroupScan##TYPENAME(temp, 2 * WG_SIZE);                                    \
+                                                                                           \
+	if (i0 < n)                                                                            \
+		out[i0] = temp[lid] + (inclusive ? v0 : 0);                                        \
+	if (i1 < n)                                                                            \
+		out[i1] = temp[lid + WG_SIZE] + (inclusive ? v1 : 0);                              \
+	if (lid == 0)                                                                          \
+		blockSums[get_group_id(0)] = total;                                                \
+}                                                                                          \
+                                                                                           \
+/* Adds the scanned block totals to every block of 2 * WG_SIZE elements */                 \
+__kernel void addBlockSums##TYPENAME(__global TYPE *out,                                   \
+                                     __global const TYPE *blockSums,                       \
+                                     const uint n)                                         \
+{                                                                                          \
+	uint lid = get_local_id(0);                                                            \
+	size_t base = get_group_id(0) * 2 * WG_SIZE;                                           \
+	TYPE sum = blockSums[get_group_id(0)];                                                 \
+                                                                                           \
+	if (base + lid < n)                                                                    \
+		out[base + lid] += sum;                                                            \
+	if (base + lid + WG_SIZE < n)                                                          \
+		out[base + lid + WG_SIZE] += sum;                                                  \
+}                                                                                          \
+                                                                                           \
+/* Reduce-scan-propagate, 1: the total of every TILE goes to partials */                   \
+__kernel void reduceTiles##TYPENAME(__global const TYPE * restrict in,                     \
+                                    __global TYPE * restrict partials,                     \
+                                    const uint n)                                          \
+{                                                                                          \
+	__local TYPE sums[WG_SIZE];                                                            \
+	uint lid = get_local_id(0);                                                            \
+	size_t base = get_group_id(0) * TILE;                                                  \
+	TYPE sum = 0;                                                                          \
+                                                                                           \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		size_t i = base + lid + k * WG_SIZE;                                               \
+		if (i < n)                                                                         \
+			sum += in[i];                                                                  \
+	}                                                                                      \
+	sums[lid] = sum;                                                                       \
+	for (uint s = WG_SIZE / 2; s > 0; s >>= 1)                                             \
+	{                                                                                      \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+		if (lid < s)                                                                       \
+			sums[lid] += sums[lid + s];                                                    \
+	}                                                                                      \
+	if (lid == 0)                                                                          \
+		partials[get_group_id(0)] = sums[0];                                               \
+}                                                                                          \
+                                                                                           \
+/* Reduce-scan-propagate, 2: exclusive scan of the tile totals by a single work-group */   \
+__kernel void scanPartials##TYPENAME(__global TYPE *partials, const uint numTiles)         \
+{                                                                                          \
+	__local TYPE temp[WG_SIZE];                                                            \
+	uint lid = get_local_id(0);                                                            \
+	TYPE carry = 0;                                                                        \
+                                                                                           \
+	for (uint base = 0; base < numTiles; base += WG_SIZE)                                  \
+	{                                                                                      \
+		uint i = base + lid;                                                               \
+		temp[lid] = (i < numTiles) ? partials[i] : 0;                                      \
+		TYPE total = WorkGroupScan##TYPENAME(temp, WG_SIZE);                               \
+		if (i < numTiles)                                                                  \
+			partials[i] = temp[lid] + carry;                                               \
+		carry += total;                                                                    \
+	}                                                                                      \
+}                                                                                          \
+                                                                                           \
+/* Reduce-scan-propagate, 3: every tile is scanned again, from its scanned total */        \
+__kernel void scanTiles##TYPENAME(__global const TYPE * restrict in,                       \
+                                  __global TYPE * restrict out,                            \
+                                  __global const TYPE * restrict partials,                 \
+                                  const uint n,                                            \
+                                  const uint inclusive)                                    \
+{                                                                                          \
+	__local TYPE tile[TILE];                                                               \
+	__local TYPE sums[WG_SIZE];                                                            \
+	TYPE items[ITEMS];                                                                     \
+	TYPE threadPrefix;                                                                     \
+	size_t base = get_group_id(0) * TILE;                                                  \
+                                                                                           \
+	LoadTile##TYPENAME(in, base, n, tile, sums, items, &threadPrefix, inclusive);          \
+	threadPrefix += partials[get_group_id(0)];                                             \
+	StoreTile##TYPENAME(out, base, n, tile, items, threadPrefix);                          \
+}                                                                                          \
+                                                                                           \
+/* Single pass scan with decoupled look-back. Tiles are handed out in launch               \
+   order by tileCounter, so the tiles a work-group waits on have already                   \
+   started. Every tile publishes its total (FLAG_AGGREGATE) as soon as it has              \
+   it and its inclusive prefix (FLAG_PREFIX) once it knows it. The first                   \
+   work-item walks back over the preceding tiles, adding aggregates, until it              \
+   finds a prefix. tileCounter and flags must be 0 before every launch */                  \
+__kernel void lookbackScan##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     volatile __global uint *tileCounter,                  \
+                                     volatile __global uint *flags,                        \
+                                     volatile __global TYPE *aggregates,                   \
+                                     volatile __global TYPE *prefixes,                     \
+                                     const uint n,                                         \
+                                     const uint inclusive)                                 \
+{                                                                                          \
+	__local TYPE tile[TILE];                                                               \
+	__local TYPE sums[WG_SIZE];                                                            \
+	__local uint tileId;                                                                   \
+	__local TYPE tilePrefix;                                                               \
+	TYPE items[ITEMS];                                                                     \
+	TYPE threadPrefix;                                                                     \
+	TYPE total;                                                                            \
+	uint lid = get_local_id(0);                                                            \
+                                                                                           \
+	if (lid == 0)                                                                          \
+		tileId = atomic_inc(tileCounter);                                                  \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	uint t = tileId;                                                                       \
+	size_t base = (size_t)t * TILE;                                                        \
+                                                                                           \
+	total = LoadTile##TYPENAME(in, base, n, tile, sums, items, &threadPrefix, inclusive);  \
+                                                                                           \
+	if (lid == 0)                                                                          \
+	{                                                                                      \
+		TYPE prefix = 0;                                                                   \
+		if (t == 0)                                                                        \
+		{                                                                                  \
+			prefixes[0] = total;                                                           \
+			write_mem_fence(CLK_GLOBAL_MEM_FENCE);                                         \
+			atomic_xchg(&flags[0], FLAG_PREFIX);                                           \
+		}                                                                                  \
+		else                                                                               \
+		{                                                                                  \
+			aggregates[t] = total;                                                         \
+			write_mem_fence(CLK_GLOBAL_MEM_FENCE);                                         \
+			atomic_xchg(&flags[t], FLAG_AGGREGATE);                                        \
+                                                                                           \
+			for (uint p = t - 1; ; p--)                                                    \
+			{                                                                              \
+				uint flag;                                                                 \
+				while ((flag = atomic_or(&flags[p], 0)) == FLAG_INVALID)                   \
+					;                                                                      \
+				read_mem_fence(CLK_GLOBAL_MEM_FENCE);                                      \
+				if (flag == FLAG_PREFIX)                                                   \
+				{                                                                          \
+					prefix += prefixes[p];                                                 \
+					break;                                                                 \
+				}                                                                          \
+				prefix += aggregates[p];                                                   \
+			}                                                                              \
+                                                                                           \
+			prefixes[t] = prefix + total;                                                  \
+			write_mem_fence(CLK_GLOBAL_MEM_FENCE);                                         \
+			atomic_xchg(&flags[t], FLAG_PREFIX);                                           \
+		}                                                                                  \
+		tilePrefix = prefix;                                                               \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	StoreTile##TYPENAME(out, base, n, tile, items, tilePrefix + threadPrefix);             \
+}                                                                                          \
+                                                                                           \
+/* Compaction, 1: flags the keys below threshold */                                        \
+__kernel void compactMark##TYPENAME(__global const TYPE * restrict in,                     \
+                                    __global uint * restrict flags,                        \
+                                    const uint n,                                          \
+                                    const TYPE threshold)                                  \
+{                                                                                          \
+	size_t i = get_global_id(0);                                                           \
+	if (i < n)                                                                             \
+		flags[i] = in[i] < threshold;                                                      \
+}                                                                                          \
+                                                                                           \
+/* Compaction, 3: after an exclusive scan of the flags, every flagged key                  \
+   knows where it goes */                                                                  \
+__kernel void compactScatter##TYPENAME(__global const TYPE * restrict in,                  \
+                                       __global const uint * restrict positions,           \
+                                       __global TYPE * restrict out,                       \
+                                       const uint n,                                       \
+                                       const TYPE threshold)                               \
+{                                                                                          \
+	size_t i = get_global_id(0);                                                           \
+	if (i < n && in[i] < threshold)                                                        \
+		out[positions[i]] = in[i];                                                         \
+}
+
+// copyKernelUint, blellochScanUint, ..., lookbackScanUint, compactMarkUint, ..., copyKernelUlong, ...
+SCAN_KERNELS(Uint, uint)
+SCAN_KERNELS(Ulong, ulong)
@@ -0,0 +1,917 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Keys are scanned from MINSCANSIZE up to what fits in device memory, SCANSIZESTEP times more every time
+#define MINSCANSIZE (1024 * 1024)
+#define SCANSIZESTEP 4
+
+// Work-items per work-group (a power of 2) and elements per work-item in the tiles, passed to kernels.cl at build time
+#define WG_SIZE 256
+#define ITEMS 8
+#define TILE (WG_SIZE * ITEMS)
+
+// Levels of block totals of the Blelloch scan, every level has 2 * WG_SIZE times less elements
+#define MAXLEVELS 8
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-launch results during test?
+// #define VERBOSE
+
+// Kernels of one key type, named scanKernelNames + Uint or Ulong
+enum { COPY, BLELLOCH, ADDBLOCKSUMS, REDUCE, SCANPARTIALS, SCANTILES, LOOKBACK, MARK, SCATTER, NUMSCANKERNELS };
+const char *scanKernelNames[NUMSCANKERNELS] = {"copyKernel", "blellochScan", "addBlockSums", "reduceTiles", "scanPartials",
+											   "scanTiles", "lookbackScan", "compactMark", "compactScatter"};
+
+// Tests, every scan is run exclusive and inclusive
+enum { COPYTEST, BLELLOCHTEST, REDUCESCANTEST, LOOKBACKTEST, COMPACTTEST, NUMTESTS };
+const char *testNames[NUMTESTS] = {"copy", "blelloch", "reduceScan", "lookback", "compact"};
+
+// Device buffers for n keys, big enough for 64-bit keys
+typedef struct
+{
+	cl_uint n, numTiles;
+	cl_mem in, out;
+	int numLevels;
+	cl_uint levelSizes[MAXLEVELS];  // Elements scanned at every level of the Blelloch scan, levelSizes[0] = n
+	cl_mem levels[MAXLEVELS];       // Block totals of every level
+	cl_mem partials;                // Tile totals of reduce-scan-propagate
+	cl_mem tileCounter, flags, aggregates, prefixes; // Look-back state
+	cl_mem compactFlags, positions; // Compaction flags and their exclusive scan
+} ScanBuffers;
+
+// Function prototypes
+double GetWallTime(void);
+int CreateScanBuffers(cl_context *context, ScanBuffers *buffers, cl_uint n);
+void ReleaseScanBuffers(ScanBuffers *buffers);
+void Launch(cl_command_queue *queue, cl_kernel kernel, size_t workItems);
+void EnqueueScan(cl_command_queue *queue, cl_kernel *kernels, ScanBuffers *buffers, int test, cl_mem in, cl_mem out, cl_uint inclusive);
+void EnqueueTest(cl_command_queue *queue, cl_kernel kernels[2][NUMSCANKERNELS], ScanBuffers *buffers, int keyType, int test,
+				 cl_uint inclusive, cl_ulong threshold);
+void RunScanTests(cl_context *context, cl_command_queue *queue, cl_kernel kernels[2][NUMSCANKERNELS], cl_uint n);
+int VerifyTest(cl_command_queue *queue, ScanBuffers *buffers, int test, cl_uint inclusive, const cl_ulong *keys, size_t typeSize,
+			   cl_ulong threshold, size_t *selected);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_device_id      device;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+	size_t            maxWorkGroupSize;
+	cl_kernel         kernels[2][NUMSCANKERNELS];
+	const char        *typeNames[2] = {"Uint", "Ulong"};
+	char              kernelName[64];
+	cl_int            err;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+	if (WG_SIZE > maxWorkGroupSize)
+	{
+		printf("WG_SIZE (%d) is over the max work-group size of the device, %zu\n", WG_SIZE, maxWorkGroupSize);
+		CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+		return EXIT_FAILURE;
+	}
+
+	for (int t = 0; t < 2; t++)
+	{
+		for (int k = 0; k < NUMSCANKERNELS; k++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "%s%s", scanKernelNames[k], typeNames[t]);
+			kernels[t][k] = clCreateKernel(program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+		}
+	}
+
+	// Scans and the copy move n keys in and n keys out, compaction n keys in and the selected ones out
+	printf("-------------------------------------------------------------------------------------------\n");
+	printf("Function             Size   Best Rate GB/s   Avg time   Min time   Max time   %% of copy\n");
+	printf("-------------------------------------------------------------------------------------------\n");
+
+	// Every size needs in and out with 64-bit keys, and the compaction flags and positions
+	for (cl_ulong n = MINSCANSIZE; n <= 0x80000000ul; n *= SCANSIZESTEP)
+	{
+		if (n * sizeof(cl_ulong) > maxAlloc || n * (2 * sizeof(cl_ulong) + 2 * sizeof(cl_uint)) > globalMemSize)
+			break;
+		RunScanTests(&context, &queue, kernels, (cl_uint)n);
+	}
+
+	for (int t = 0; t < 2; t++)
+		for (int k = 0; k < NUMSCANKERNELS; k++)
+			clReleaseKernel(kernels[t][k]);
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Creates every buffer used by the tests on n keys. Returns EXIT_FAILURE if there are too many levels.
+int CreateScanBuffers(cl_context *context, ScanBuffers *buffers, cl_uint n)
+{
+	cl_int err;
+	cl_uint blockSize = 2 * WG_SIZE;
+
+	memset(buffers, 0, sizeof(*buffers));
+	buffers->n = n;
+	buffers->numTiles = (n + TILE - 1) / TILE;
+	buffers->in = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_ulong), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->out = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_ulong), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// One block total per block of every level, down to a single block
+	buffers->levelSizes[0] = n;
+	for (int l = 0; ; l++)
+	{
+		cl_uint blocks = (buffers->levelSizes[l] + blockSize - 1) / blockSize;
+		if (l == MAXLEVELS)
+		{
+			printf("More than MAXLEVELS levels in the Blelloch scan\n");
+			return EXIT_FAILURE;
+		}
+		buffers->levels[l] = clCreateBuffer(*context, CL_MEM_READ_WRITE, blocks * sizeof(cl_ulong), NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+		buffers->numLevels = l + 1;
+		if (blocks == 1)
+			break;
+		buffers->levelSizes[l + 1] = blocks;
+	}
+
+	buffers->partials = clCreateBuffer(*context, CL_MEM_READ_WRITE, buffers->numTiles * sizeof(cl_ulong), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->tileCounter = clCreateBuffer(*context, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->flags = clCreateBuffer(*context, CL_MEM_READ_WRITE, buffers->numTiles * sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->aggregates = clCreateBuffer(*context, CL_MEM_READ_WRITE, buffers->numTiles * sizeof(cl_ulong), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->prefixes = clCreateBuffer(*context, CL_MEM_READ_WRITE, buffers->numTiles * sizeof(cl_ulong), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->compactFlags = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	buffers->positions = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	return EXIT_SUCCESS;
+}
+
+void ReleaseScanBuffers(ScanBuffers *buffers)
+{
+	clReleaseMemObject(buffers->in);
+	clReleaseMemObject(buffers->out);
+	for (int l = 0; l < buffers->numLevels; l++)
+		clReleaseMemObject(buffers->levels[l]);
+	clReleaseMemObject(buffers->partials);
+	clReleaseMemObject(buffers->tileCounter);
+	clReleaseMemObject(buffers->flags);
+	clReleaseMemObject(buffers->aggregates);
+	clReleaseMemObject(buffers->prefixes);
+	clReleaseMemObject(buffers->compactFlags);
+	clReleaseMemObject(buffers->positions);
+}
+
+// Enqueues at least workItems work-items, in work-groups of WG_SIZE
+void Launch(cl_command_queue *queue, cl_kernel kernel, size_t workItems)
+{
+	size_t localSize = WG_SIZE;
+	size_t globalSize = (workItems + WG_SIZE - 1) / WG_SIZE * WG_SIZE;
+	cl_int err = clEnqueueNDRangeKernel(*queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+	CheckOpenCLError(err, __LINE__);
+}
+
+// Enqueues a scan of the n keys of in to out with the kernels of one key type
+void EnqueueScan(cl_command_queue *queue, cl_kernel *kernels, ScanBuffers *buffers, int test, cl_mem in, cl_mem out, cl_uint inclusive)
+{
+	const cl_uint zero = 0;
+	cl_uint n = buffers->n;
+	cl_uint blockSize = 2 * WG_SIZE;
+	cl_int err = CL_SUCCESS;
+
+	if (test == BLELLOCHTEST)
+	{
+		// Scan the blocks of every level, the block totals are the next level, scanned in place
+		for (int l = 0; l < buffers->numLevels; l++)
+		{
+			cl_mem src = (l == 0) ? in : buffers->levels[l - 1];
+			cl_mem dst = (l == 0) ? out : buffers->levels[l - 1];
+			cl_uint levelInclusive = (l == 0) ? inclusive : 0;
+			err |= clSetKernelArg(kernels[BLELLOCH], 0, sizeof(cl_mem), &src);
+			err |= clSetKernelArg(kernels[BLELLOCH], 1, sizeof(cl_mem), &dst);
+			err |= clSetKernelArg(kernels[BLELLOCH], 2, sizeof(cl_mem), &buffers->levels[l]);
+			err |= clSetKernelArg(kernels[BLELLOCH], 3, sizeof(cl_uint), &buffers->levelSizes[l]);
+			err |= clSetKernelArg(kernels[BLELLOCH], 4, sizeof(cl_uint), &levelInclusive);
+			CheckOpenCLError(err, __LINE__);
+			Launch(queue, kernels[BLELLOCH], (buffers->levelSizes[l] + blockSize - 1) / blockSize * WG_SIZE);
+		}
+
+		// Then add them back, from the top level down
+		for (int l = buffers->numLevels - 2; l >= 0; l--)
+		{
+			cl_mem dst = (l == 0) ? out : buffers->levels[l - 1];
+			err |= clSetKernelArg(kernels[ADDBLOCKSUMS], 0, sizeof(cl_mem), &dst);
+			err |= clSetKernelArg(kernels[ADDBLOCKSUMS], 1, sizeof(cl_mem), &buffers->levels[l]);
+			err |= clSetKernelArg(kernels[ADDBLOCKSUMS], 2, sizeof(cl_uint), &buffers->levelSizes[l]);
+			CheckOpenCLError(err, __LINE__);
+			Launch(queue, kernels[ADDBLOCKSUMS], (buffers->levelSizes[l] + blockSize - 1) / blockSize * WG_SIZE);
+		}
+	}
+	else if (test == REDUCESCANTEST)
+	{
+		err |= clSetKernelArg(kernels[REDUCE], 0, sizeof(cl_mem), &in);
+		err |= clSetKernelArg(kernels[REDUCE], 1, sizeof(cl_mem), &buffers->partials);
+		err |= clSetKernelArg(kernels[REDUCE], 2, sizeof(cl_uint), &n);
+		err |= clSetKernelArg(kernels[SCANPARTIALS], 0, sizeof(cl_mem), &buffers->partials);
+		err |= clSetKernelArg(kernels[SCANPARTIALS], 1, sizeof(cl_uint), &buffers->numTiles);
+		err |= clSetKernelArg(kernels[SCANTILES], 0, sizeof(cl_mem), &in);
+		err |= clSetKernelArg(kernels[SCANTILES], 1, sizeof(cl_mem), &out);
+		err |= clSetKernelArg(kernels[SCANTILES], 2, sizeof(cl_mem), &buffers->partials);
+		err |= clSetKernelArg(kernels[SCANTILES], 3, sizeof(cl_uint), &n);
+		err |= clSetKernelArg(kernels[SCANTILES], 4, sizeof(cl_uint), &inclusive);
+		CheckOpenCLError(err, __LINE__);
+		Launch(queue, kernels[REDUCE], (size_t)buffers->numTiles * WG_SIZE);
+		Launch(queue, kernels[SCANPARTIALS], WG_SIZE);
+		Launch(queue, kernels[SCANTILES], (size_t)buffers->numTiles * WG_SIZE);
+	}
+	else if (test == LOOKBACKTEST)
+	{
+		// The tile counter and flags are reset on every run, it's part of the cost of the single pass
+		err |= clEnqueueFillBuffer(*queue, buffers->tileCounter, &zero, sizeof(zero), 0, sizeof(cl_uint), 0, NULL, NULL);
+		err |= clEnqueueFillBuffer(*queue, buffers->flags, &zero, sizeof(zero), 0, buffers->numTiles * sizeof(cl_uint), 0, NULL, NULL);
+		err |= clSetKernelArg(kernels[LOOKBACK], 0, sizeof(cl_mem), &in);
+		err |= clSetKernelArg(kernels[LOOKBACK], 1, sizeof(cl_mem), &out);
+		err |= clSetKernelArg(kernels[LOOKBACK], 2, sizeof(cl_mem), &buffers->tileCounter);
+		err |= clSetKernelArg(kernels[LOOKBACK], 3, sizeof(cl_mem), &buffers->flags);
+		err |= clSetKernelArg(kernels[LOOKBACK], 4, sizeof(cl_mem), &buffers->aggregates);
+		err |= clSetKernelArg(kernels[LOOKBACK], 5, sizeof(cl_mem), &buffers->prefixes);
+		err |= clSetKernelArg(kernels[LOOKBACK], 6, sizeof(cl_uint), &n);
+		err |= clSetKernelArg(kernels[LOOKBACK], 7, sizeof(cl_uint), &inclusive);
+		CheckOpenCLError(err, __LINE__);
+		Launch(queue, kernels[LOOKBACK], (size_t)buffers->numTiles * WG_SIZE);
+	}
+}
+
+// Enqueues one run of a test on the keys in buffers->in. keyType is 0 for 32-bit keys and 1 for 64-bit keys.
+// Compaction keeps the keys below threshold, the flags are scanned with the 32-bit reduce-scan-propagate.
+void EnqueueTest(cl_command_queue *queue, cl_kernel kernels[2][NUMSCANKERNELS], ScanBuffers *buffers, int keyType, int test,
+				 cl_uint inclusive, cl_ulong threshold)
+{
+	cl_kernel *typeKernels = kernels[keyType];
+	cl_uint threshold32 = (cl_uint)threshold;
+	size_t typeSize = keyType ? sizeof(cl_ulong) : sizeof(cl_uint);
+	const void *thresholdArg = keyType ? (const void *)&threshold : (const void *)&threshold32;
+	cl_int err = CL_SUCCESS;
+
+	if (test == COPYTEST)
+	{
+		err |= clSetKernelArg(typeKernels[COPY], 0, sizeof(cl_mem), &buffers->in);
+		err |= clSetKernelArg(typeKernels[COPY], 1, sizeof(cl_mem), &buffers->out);
+		err |= clSetKernelArg(typeKernels[COPY], 2, sizeof(cl_uint), &buffers->n);
+		CheckOpenCLError(err, __LINE__);
+		Launch(queue, typeKernels[COPY], buffers->n);
+	}
+	else if (test == COMPACTTEST)
+	{
+		err |= clSetKernelArg(typeKernels[MARK], 0, sizeof(cl_mem), &buffers->in);
+		err |= clSetKernelArg(typeKernels[MARK], 1, sizeof(cl_mem), &buffers->compactFlags);
+		err |= clSetKernelArg(typeKernels[MARK], 2, sizeof(cl_uint), &buffers->n);
+		err |= clSetKernelArg(typeKernels[MARK], 3, typeSize, thresholdArg);
+		err |= clSetKernelArg(typeKernels[SCATTER], 0, sizeof(cl_mem), &buffers->in);
+		err |= clSetKernelArg(typeKernels[SCATTER], 1, sizeof(cl_mem), &buffers->positions);
+		err |= clSetKernelArg(typeKernels[SCATTER], 2, sizeof(cl_mem), &buffers->out);
+		err |= clSetKernelArg(typeKernels[SCATTER], 3, sizeof(cl_uint), &buffers->n);
+		err |= clSetKernelArg(typeKernels[SCATTER], 4, typeSize, thresholdArg);
+		CheckOpenCLError(err, __LINE__);
+		Launch(queue, typeKernels[MARK], buffers->n);
+		EnqueueScan(queue, kernels[0], buffers, REDUCESCANTEST, buffers->compactFlags, buffers->positions, 0);
+		Launch(queue, typeKernels[SCATTER], buffers->n);
+	}
+	else
+	{
+		EnqueueScan(queue, typeKernels, buffers, test, buffers->in, buffers->out, inclusive);
+	}
+}
+
+// Reads back the result of a test and checks it against the host. For compaction, selected is set to the number of keys kept.
+int VerifyTest(cl_command_queue *queue, ScanBuffers *buffers, int test, cl_uint inclusive, const cl_ulong *keys, size_t typeSize,
+			   cl_ulong threshold, size_t *selected)
+{
+	cl_ulong mask = (typeSize == sizeof(cl_uint)) ? 0xFFFFFFFFul : ~(cl_ulong)0;
+	size_t n = buffers->n;
+	size_t expected = 0;
+	cl_ulong sum = 0;
+	int result = EXIT_SUCCESS;
+	void *out = malloc(n * typeSize);
+
+	clEnqueueReadBuffer(*queue, buffers->out, CL_TRUE, 0, n * typeSize, out, 0, NULL, NULL);
+	for (size_t i = 0; i < n; i++)
+	{
+		cl_ulong key = keys[i] & mask;
+		cl_ulong want;
+		size_t j = i;
+
+		if (test == COPYTEST)
+		{
+			want = key;
+		}
+		else if (test == COMPACTTEST)
+		{
+			if (key >= threshold)
+				continue;
+			want = key;
+			j = expected++;
+		}
+		else
+		{
+			if (inclusive)
+				sum = (sum + key) & mask;
+			want = sum;
+			if (!inclusive)
+				sum = (sum + key) & mask;
+		}
+
+		cl_ulong got = (typeSize == sizeof(cl_uint)) ? ((cl_uint *)out)[j] : ((cl_ulong *)out)[j];
+		if (got != want)
+		{
+			printf("Error in %s, element %zu is %llu, expected %llu\n", testNames[test], j, (unsigned long long)got, (unsigned long long)want);
+			result = EXIT_FAILURE;
+			break;
+		}
+	}
+
+	// The last position plus the last flag is the number of keys kept
+	if (test == COMPACTTEST && result == EXIT_SUCCESS)
+	{
+		cl_uint lastPosition;
+		clEnqueueReadBuffer(*queue, buffers->positions, CL_TRUE, (n - 1) * sizeof(cl_uint), sizeof(cl_uint), &lastPosition, 0, NULL, NULL);
+		if (lastPosition + ((keys[n - 1] & mask) < threshold) != expected)
+		{
+			printf("Error in %s, %u keys kept, expected %zu\n", testNames[test], lastPosition + ((keys[n - 1] & mask) < threshold), expected);
+			result = EXIT_FAILURE;
+		}
+	}
+
+	*selected = expected;
+	free(out);
+	return result;
+}
+
+// Runs every test on n random keys, 32-bit then 64-bit
+void RunScanTests(cl_context *context, cl_command_queue *queue, cl_kernel kernels[2][NUMSCANKERNELS], cl_uint n)
+{
+	const size_t typeSizes[2] = {sizeof(cl_uint), sizeof(cl_ulong)};
+	const char *suffixes[2] = {"32", "64"};
+	ScanBuffers buffers;
+	char testName[64];
+	cl_int err;
+
+	cl_ulong *keys = malloc((size_t)n * sizeof(cl_ulong));
+	void *typedKeys = malloc((size_t)n * sizeof(cl_ulong));
+	if (keys == NULL || typedKeys == NULL)
+	{
+		printf("Not enough host memory for %u keys\n", n);
+		free(keys);
+		free(typedKeys);
+		return;
+	}
+	if (CreateScanBuffers(context, &buffers, n) == EXIT_FAILURE)
+	{
+		free(keys);
+		free(typedKeys);
+		return;
+	}
+
+	// rand() may only give 15 bits, so several calls are combined
+	srand(0);
+	for (size_t i = 0; i < n; i++)
+		keys[i] = ((cl_ulong)rand() << 45) ^ ((cl_ulong)rand() << 30) ^ ((cl_ulong)rand() << 15) ^ (cl_ulong)rand();
+
+	for (int t = 0; t < 2; t++)
+	{
+		// Compaction keeps the keys in the lower half of the range, about half of them
+		cl_ulong threshold = (t == 0) ? 0x80000000ul : 0x8000000000000000ul;
+		double copyTime = 0.0;
+
+		for (size_t i = 0; i < n; i++)
+		{
+			if (t == 0)
+				((cl_uint *)typedKeys)[i] = (cl_uint)keys[i];
+			else
+				((cl_ulong *)typedKeys)[i] = keys[i];
+		}
+		err = clEnqueueWriteBuffer(*queue, buffers.in, CL_TRUE, 0, (size_t)n * typeSizes[t], typedKeys, 0, NULL, NULL);
+		CheckOpenCLError(err, __LINE__);
+
+		for (int test = 0; test < NUMTESTS; test++)
+		{
+			// Copy and compaction don't have inclusive versions
+			cl_uint numVersions = (test == COPYTEST || test == COMPACTTEST) ? 1 : 2;
+
+			for (cl_uint inclusive = 0; inclusive < numVersions; inclusive++)
+			{
+				double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+				size_t selected;
+
+				if (test == COPYTEST || test == COMPACTTEST)
+					snprintf(testName, sizeof(testName), "%s%s", testNames[test], suffixes[t]);
+				else
+					snprintf(testName, sizeof(testName), "%s%s%s", testNames[test], inclusive ? "Incl" : "Excl", suffixes[t]);
+
+				EnqueueTest(queue, kernels, &buffers, t, test, inclusive, threshold);
+				// A wrong result isn't worth timing, the row is flagged instead
+				if (VerifyTest(queue, &buffers, test, inclusive, keys, typeSizes[t], threshold, &selected) == EXIT_FAILURE)
+				{
+					printf("%-16s %10u   wrong output, skipped\n", testName, n);
+					continue;
+				}
+
+				for (int k = 0; k < NTIMES; k++)
+				{
+					double time = GetWallTime();
+					EnqueueTest(queue, kernels, &buffers, t, test, inclusive, threshold);
+					clFinish(*queue);
+					time = GetWallTime() - time;
+
+					if (time < bestTime)
+					{
+						bestTime = time;
+					}
+					if (time > worstTime)
+					{
+						worstTime = time;
+					}
+					totalTime += time;
+
+#ifdef VERBOSE
+					printf("------------- %s run %2d, %8.6lf s\n", testName, k, time);
+#endif
+				}
+
+				if (test == COPYTEST)
+					copyTime = bestTime;
+				size_t keysMoved = (test == COMPACTTEST) ? n + selected : 2 * (size_t)n;
+				double bandwidth = keysMoved * typeSizes[t] / 1024.0 / 1024.0 / 1024.0 / bestTime;
+				// Without a valid copy there's nothing to compare against
+				double copyBandwidth = copyTime > 0.0 ? 2 * (size_t)n * typeSizes[t] / 1024.0 / 1024.0 / 1024.0 / copyTime : 0.0;
+				printf("%-16s %10u   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %8.1lf%%\n",
+					   testName, n, bandwidth, totalTime / NTIMES, bestTime, worstTime, copyBandwidth > 0.0 ? 100.0 * bandwidth / copyBandwidth : 0.0);
+			}
+		}
+		printf("-------------------------------------------------------------------------------------------\n");
+	}
+
+	ReleaseScanBuffers(&buffers);
+	free(keys);
+	free(typedKeys);
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	char buildOptions[128];
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -DWG_SIZE=%d -DITEMS=%d", WG_SIZE, ITEMS);
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -0,0 +1,341 @@
+// Work-items per work-group (a power of 2), keys per work-item and bits sorted per pass. Set by the host with -D.
+#ifndef WG_SIZE
+#define WG_SIZE 256
+#endif
+#ifndef ITEMS
+#define ITEMS 4
+#endif
+#ifndef RADIX_BITS
+#define RADIX_BITS 4
+#endif
+
+// Every work-group sorts a tile of TILE keys per pass, into RADIX buckets
+#define TILE (WG_SIZE * ITEMS)
+#define RADIX (1 << RADIX_BITS)
+
+// Blelloch exclusive scan of n elements (a power of 2) of temp, in place, by the whole work-group. Returns the total.
+uint WorkGroupScan(__local uint *temp, uint n)
+{
+	uint lid = get_local_id(0);
+	uint offset = 1;
+	uint total;
+
+	// Up-sweep, builds the sums of the tree in place
+	for (uint d = n >> 1; d > 0; d >>= 1, offset <<= 1)
+	{
+		barrier(CLK_LOCAL_MEM_FENCE);
+		for (uint i = lid; i < d; i += WG_SIZE)
+			temp[offset * (2 * i + 2) - 1] += temp[offset * (2 * i + 1) - 1];
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	total = temp[n - 1];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (lid == 0)
+		temp[n - 1] = 0;
+
+	// Down-sweep, pushes the prefixes back down the tree
+	for (uint d = 1; d < n; d <<= 1)
+	{
+		offset >>= 1;
+		barrier(CLK_LOCAL_MEM_FENCE);
+		for (uint i = lid; i < d; i += WG_SIZE)
+		{
+			uint ai = offset * (2 * i + 1) - 1;
+			uint bi = offset * (2 * i + 2) - 1;
+			uint t = temp[ai];
+			temp[ai] = temp[bi];
+			temp[bi] += t;
+		}
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return total;
+}
+
+// Exclusive scan of the bucket counts, reduce-scan-propagate in three kernels (see the scan benchmark).
+// 1: the total of every TILE of counts goes to partials
+__kernel void reduceCounts(__global const uint * restrict counts, __global uint * restrict partials, const uint n)
+{
+	__local uint sums[WG_SIZE];
+	uint lid = get_local_id(0);
+	size_t base = get_group_id(0) * TILE;
+	uint sum = 0;
+
+	for (uint k = 0; k < ITEMS; k++)
+	{
+		size_t i = base + lid + k * WG_SIZE;
+		if (i < n)
+			sum += counts[i];
+	}
+	sums[lid] = sum;
+	for (uint s = WG_SIZE / 2; s > 0; s >>= 1)
+	{
+		barrier(CLK_LOCAL_MEM_FENCE);
+		if (lid < s)
+			sums[lid] += sums[lid + s];
+	}
+	if (lid == 0)
+		partials[get_group_id(0)] = sums[0];
+}
+
+// 2: exclusive scan of the tile totals by a single work-group
+__kernel void scanPartials(__global uint *partials, const uint numTiles)
+{
+	__local uint temp[WG_SIZE];
+	uint lid = get_local_id(0);
+	uint carry = 0;
+
+	for (uint base = 0; base < numTiles; base += WG_SIZE)
+	{
+		uint i = base + lid;
+		temp[lid] = (i < numTiles) ? partials[i] : 0;
+		uint total = WorkGroupScan(temp, WG_SIZE);
+		if (i < numTiles)
+			partials[i] = temp[lid] + carry;
+		carry += total;
+	}
+}
+
+// 3: every tile of counts is scanned in place, starting from its scanned total
+__kernel void scanCounts(__global uint *counts, __global const uint *partials, const uint n)
+{
+	__local uint tile[TILE];
+	__local uint sums[WG_SIZE];
+	uint lid = get_local_id(0);
+	size_t base = get_group_id(0) * TILE;
+	uint items[ITEMS];
+	uint sum = 0;
+
+	for (uint k = 0; k < ITEMS; k++)
+	{
+		size_t i = base + lid + k * WG_SIZE;
+		tile[lid + k * WG_SIZE] = (i < n) ? counts[i] : 0;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for (uint k = 0; k < ITEMS; k++)
+	{
+		items[k] = sum;
+		sum += tile[lid * ITEMS + k];
+	}
+	sums[lid] = sum;
+	WorkGroupScan(sums, WG_SIZE);
+	sum = sums[lid] + partials[get_group_id(0)];
+	for (uint k = 0; k < ITEMS; k++)
+		tile[lid * ITEMS + k] = items[k] + sum;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for (uint k = 0; k < ITEMS; k++)
+	{
+		size_t i = base + lid + k * WG_SIZE;
+		if (i < n)
+			counts[i] = tile[lid + k * WG_SIZE];
+	}
+}
+
+// values[i] = i, the values sorted along with the keys are their original positions
+__kernel void initValues(__global uint *values, const uint n)
+{
+	size_t i = get_global_id(0);
+	if (i < n)
+		values[i] = i;
+}
+
+// One LSD pass sorts the RADIX_BITS bits of the keys from shift up:
+// - radixHistogram counts the keys of every tile in each bucket, with local atomics. The counts are stored
+//   bucket major, counts[bucket * numTiles + tile], so their exclusive scan is where every tile writes every bucket.
+// - radixScatter sorts every tile in local memory by the bucket with RADIX_BITS 1-bit splits, which keeps the
+//   order of equal keys, and writes the keys of every bucket next to each other. radixScatterPairs moves values too.
+#define SORT_KERNELS(TYPENAME, TYPE)                                                       \
+                                                                                           \
+/* Bucket of a key in the pass from shift */                                               \
+uint Digit##TYPENAME(TYPE key, uint shift)                                                 \
+{                                                                                          \
+	return (uint)(key >> shift) & (RADIX - 1);                                             \
+}                                                                                          \
+                                                                                           \
+__kernel void radixHistogram##TYPENAME(__global const TYPE * restrict keys,                \
+                                       __global uint * restrict counts,                    \
+                                       const uint n,                                       \
+                                       const uint shift,                                   \
+                                       const uint numTiles)                                \
+{                                                                                          \
+	__local uint histogram[RADIX];                                                         \
+	uint lid = get_local_id(0);                                                            \
+	size_t base = get_group_id(0) * TILE;                                                  \
+                                                                                           \
+	for (uint d = lid; d < RADIX; d += WG_SIZE)                                            \
+		histogram[d] = 0;                                                                  \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		size_t i = base + lid + k * WG_SIZE;                                               \
+		if (i < n)                                                                         \
+			atomic_inc(&histogram[Digit##TYPENAME(keys[i], shift)]);                       \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	for (uint d = lid; d < RADIX; d += WG_SIZE)                                            \
+		counts[d * numTiles + get_group_id(0)] = histogram[d];                             \
+}                                                                                          \
+                                                                                           \
+/* Sorts the tile of keys (and values, if withValues) of the work-group by the             \
+   pass bucket and writes them to their place in the output. offsets are the               \
+   scanned counts. Tiles are padded with keys of all ones, so the padding                  \
+   sorts after the real keys */                                                            \
+void SortTile##TYPENAME(__global const TYPE *keysIn, __global TYPE *keysOut,               \
+                        __global const uint *valuesIn, __global uint *valuesOut,           \
+                        __global const uint *offsets, uint n, uint shift, uint numTiles,   \
+                        __local TYPE *keyTile, __local uint *valueTile,                    \
+                        __local uint *sums, __local uint *bucketStart,                     \
+                        __local uint *bucketOffset, int withValues)                        \
+{                                                                                          \
+	uint lid = get_local_id(0);                                                            \
+	size_t base = get_group_id(0) * TILE;                                                  \
+	uint valid = (n - base < TILE) ? (uint)(n - base) : TILE;                              \
+	TYPE keys[ITEMS];                                                                      \
+	uint values[ITEMS];                                                                    \
+                                                                                           \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		uint j = lid + k * WG_SIZE;                                                        \
+		keyTile[j] = (j < valid) ? keysIn[base + j] : (TYPE)~(TYPE)0;                      \
+		if (withValues)                                                                    \
+			valueTile[j] = (j < valid) ? valuesIn[base + j] : 0;                           \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		keys[k] = keyTile[lid * ITEMS + k];                                                \
+		if (withValues)                                                                    \
+			values[k] = valueTile[lid * ITEMS + k];                                        \
+	}                                                                                      \
+                                                                                           \
+	/* 1-bit splits, keys with the bit clear go first, in order, then the rest */          \
+	for (uint bit = shift; bit < shift + RADIX_BITS; bit++)                                \
+	{                                                                                      \
+		uint zeros = 0;                                                                    \
+		for (uint k = 0; k < ITEMS; k++)                                                   \
+			zeros += ((keys[k] >> bit) & 1) == 0;                                          \
+		sums[lid] = zeros;                                                                 \
+		uint totalZeros = WorkGroupScan(sums, WG_SIZE);                                    \
+		uint zerosBefore = sums[lid];                                                      \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+                                                                                           \
+		for (uint k = 0; k < ITEMS; k++)                                                   \
+		{                                                                                  \
+			uint position = lid * ITEMS + k;                                               \
+			uint destination;                                                              \
+			if (((keys[k] >> bit) & 1) == 0)                                               \
+				destination = zerosBefore++;                                               \
+			else                                                                           \
+				destination = totalZeros + position - zerosBefore;                         \
+			keyTile[destination] = keys[k];                                                \
+			if (withValues)                                                                \
+				valueTile[destination] = values[k];                                        \
+		}                                                                                  \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+		for (uint k = 0; k < ITEMS; k++)                                                   \
+		{                                                                                  \
+			keys[k] = keyTile[lid * ITEMS + k];                                            \
+			if (withValues)                                                                \
+				values[k] = valueTile[lid * ITEMS + k];                                    \
+		}                                                                                  \
+	}                                                                                      \
+                                                                                           \
+	/* Where every bucket starts in the sorted tile, and in the output */                  \
+	for (uint d = lid; d < RADIX; d += WG_SIZE)                                            \
+		sums[d] = 0;                                                                       \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+		if (lid * ITEMS + k < valid)                                                       \
+			atomic_inc(&sums[Digit##TYPENAME(keys[k], shift)]);                            \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+	if (lid == 0)                                                                          \
+	{                                                                                      \
+		uint start = 0;                                                                    \
+		for (uint d = 0; d < RADIX; d++)                                                   \
+		{                                                                                  \
+			bucketStart[d] = start;                                                        \
+			start += sums[d];                                                              \
+		}                                                                                  \
+	}                                                                                      \
+	for (uint d = lid; d < RADIX; d += WG_SIZE)                                            \
+		bucketOffset[d] = offsets[d * numTiles + get_group_id(0)];                         \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	/* Work-items next to each other write keys of the same bucket next to each other */   \
+	for (uint k = 0; k < ITEMS; k++)                                                       \
+	{                                                                                      \
+		uint j = lid + k * WG_SIZE;                                                        \
+		if (j < valid)                                                                     \
+		{                                                                                  \
+			TYPE key = keyTile[j];                                                         \
+			uint d = Digit##TYPENAME(key, shift);                                          \
+			size_t destination = (size_t)bucketOffset[d] + j - bucketStart[d];             \
+			keysOut[destination] = key;                                                    \
+			if (withValues)                                                                \
+				valuesOut[destination] = valueTile[j];                                     \
+		}                                                                                  \
+	}                                                                                      \
+}                                                                                          \
+                                                                                           \
+__kernel void radixScatter##TYPENAME(__global const TYPE * restrict keysIn,                \
+                                     __global TYPE * restrict keysOut,                     \
+                                     __global const uint * restrict offsets,               \
+                                     const uint n,                                         \
+                                     const uint shift,                                     \
+                                     const uint numTiles)                                  \
+{                                                                                          \
+	__local TYPE keyTile[TILE];                                                            \
+	__local uint sums[WG_SIZE > RADIX ? WG_SIZE : RADIX];                                  \
+	__local uint bucketStart[RADIX];                                                       \
+	__local uint bucketOffset[RADIX];                                                      \
+                                                                                           \
+	SortTile##TYPENAME(keysIn, keysOut, 0, 0, offsets, n, shift, numTiles,                 \
+	                   keyTile, 0, sums, bucketStart, bucketOffset, 0);                    \
+}                                                                                          \
+                                                                                           \
+__kernel void radixScatterPairs##TYPENAME(__global const TYPE * restrict keysIn,           \
+                                          __global TYPE * restrict keysOut,                \
+                                          __global const uint * restrict valuesIn,         \
+                                          __global uint * restrict valuesOut,              \
+                                          __global const uint * restrict offsets,          \
+                                          const uint n,                                    \
+                                          const uint shift,                                \
+                                          const uint numTiles)                             \
+{                                                                                          \
+	__local TYPE keyTile[TILE];                                                            \
+	__local uint valueTile[TILE];                                                          \
+	__local uint sums[WG_SIZE > RADIX ? WG_SIZE : RADIX];                                  \
+	__local uint bucketStart[RADIX];                                                       \
+	__local uint bucketOffset[RADIX];                                                      \
+                                                                                           \
+	SortTile##TYPENAME(keysIn, keysOut, valuesIn, valuesOut, offsets, n, shift, numTiles,  \
+	                   keyTile, valueTile, sums, bucketStart, bucketOffset, 1);            \
+}                                                                                          \
+                                                                                           \
+/* Counts the keys out of order into errors */                                             \
+__kernel void checkSorted##TYPENAME(__global const TYPE * restrict keys,                   \
+                                    const uint n,                                          \
+                                    __global uint * restrict errors)                       \
+{                                                                                          \
+	size_t i = get_global_id(0);                                                           \
+	if (i + 1 < n && keys[i] > keys[i + 1])                                                \
+		atomic_inc(errors);                                                                \
+}                                                                                          \
+                                                                                           \
+/* Counts the keys that don't match the original key at the position of                    \
+   their value into errors */                                                              \
+__kernel void checkPairs##TYPENAME(__global const TYPE * restrict keys,                    \
+                                   __global const uint * restrict values,                  \
+                                   __global const TYPE * restrict original,                \
+                                   const uint n,                                           \
+                                   __global uint * restrict errors)                        \
+{                                                                                          \
+	size_t i = get_global_id(0);                                                           \
+	if (i < n && (values[i] >= n || original[values[i]] != keys[i]))                       \
+		atomic_inc(errors);                                                                \
+}
+
+// radixHistogramUint, radixScatterUint, radixScatterPairsUint, checkSortedUint, checkPairsUint, ...Ulong
+SORT_KERNELS(Uint, uint)
+SORT_KERNELS(Ulong, ulong)
@@ -0,0 +1,763 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Keys are sorted from MINSORTSIZE up to the max allocation, SORTSIZESTEP times more every time
+#define MINSORTSIZE (1024 * 1024)
+#define SORTSIZESTEP 4
+
+// Work-items per work-group (a power of 2), keys per work-item and bits sorted per pass, passed to kernels.cl at build time.
+// RADIX_BITS must divide 32.
+#define WG_SIZE 256
+#define ITEMS 4
+#define RADIX_BITS 4
+#define TILE (WG_SIZE * ITEMS)
+#define RADIX (1 << RADIX_BITS)
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-run results during test?
+// #define VERBOSE
+
+// Kernels of one key type, named sortKernelNames + Uint or Ulong
+enum { HISTOGRAM, SCATTER, SCATTERPAIRS, CHECKSORTED, CHECKPAIRS, NUMSORTKERNELS };
+const char *sortKernelNames[NUMSORTKERNELS] = {"radixHistogram", "radixScatter", "radixScatterPairs", "checkSorted", "checkPairs"};
+
+// Kernels shared by both key types
+enum { REDUCECOUNTS, SCANPARTIALS, SCANCOUNTS, INITVALUES, NUMSHAREDKERNELS };
+const char *sharedKernelNames[NUMSHAREDKERNELS] = {"reduceCounts", "scanPartials", "scanCounts", "initValues"};
+
+// Device buffers for n keys and values, big enough for 64-bit keys. keys[0] and values[0] end up sorted.
+typedef struct
+{
+	cl_uint n, numTiles, numCounts, numCountTiles;
+	cl_mem original;            // Unsorted keys
+	cl_mem keys[2], values[2];  // Ping-pong between passes
+	cl_mem counts;              // Keys of every tile in every bucket, RADIX * numTiles
+	cl_mem partials;            // Tile totals of the scan of counts
+	cl_mem errors;
+} SortBuffers;
+
+// Function prototypes
+double GetWallTime(void);
+void Launch(cl_command_queue *queue, cl_kernel kernel, size_t workItems);
+void EnqueueSort(cl_command_queue *queue, cl_kernel *kernels, cl_kernel *sharedKernels, SortBuffers *buffers, size_t typeSize, int withValues);
+cl_uint CheckSort(cl_command_queue *queue, cl_kernel *kernels, SortBuffers *buffers, int withValues);
+void RunSortTests(cl_context *context, cl_command_queue *queue, cl_kernel kernels[2][NUMSORTKERNELS], cl_kernel *sharedKernels, cl_uint n);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_device_id      device;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+	size_t            maxWorkGroupSize;
+	cl_kernel         kernels[2][NUMSORTKERNELS];
+	cl_kernel         sharedKernels[NUMSHAREDKERNELS];
+	const char        *typeNames[2] = {"Uint", "Ulong"};
+	char              kernelName[64];
+	cl_int            err;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+	if (WG_SIZE > maxWorkGroupSize)
+	{
+		printf("WG_SIZE (%d) is over the max work-group size of the device, %zu\n", WG_SIZE, maxWorkGroupSize);
+		CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+		return EXIT_FAILURE;
+	}
+
+	for (int t = 0; t < 2; t++)
+	{
+		for (int k = 0; k < NUMSORTKERNELS; k++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "%s%s", sortKernelNames[k], typeNames[t]);
+			kernels[t][k] = clCreateKernel(program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+		}
+	}
+	for (int k = 0; k < NUMSHAREDKERNELS; k++)
+	{
+		sharedKernels[k] = clCreateKernel(program, sharedKernelNames[k], &err);
+		CheckOpenCLError(err, __LINE__);
+	}
+
+	printf("------------------------------------------------------------------------------------\n");
+	printf("Function               Size   Passes   Best Mkeys/s   Avg time   Min time   Max time\n");
+	printf("------------------------------------------------------------------------------------\n");
+
+	// Every size needs the original and two key buffers with 64-bit keys, and two value buffers
+	for (cl_ulong n = MINSORTSIZE; n <= 0x80000000ul; n *= SORTSIZESTEP)
+	{
+		if (n * sizeof(cl_ulong) > maxAlloc || n * (3 * sizeof(cl_ulong) + 2 * sizeof(cl_uint)) > globalMemSize)
+			break;
+		RunSortTests(&context, &queue, kernels, sharedKernels, (cl_uint)n);
+	}
+
+	for (int t = 0; t < 2; t++)
+		for (int k = 0; k < NUMSORTKERNELS; k++)
+			clReleaseKernel(kernels[t][k]);
+	for (int k = 0; k < NUMSHAREDKERNELS; k++)
+		clReleaseKernel(sharedKernels[k]);
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Enqueues at least workItems work-items, in work-groups of WG_SIZE
+void Launch(cl_command_queue *queue, cl_kernel kernel, size_t workItems)
+{
+	size_t localSize = WG_SIZE;
+	size_t globalSize = (workItems + WG_SIZE - 1) / WG_SIZE * WG_SIZE;
+	cl_int err = clEnqueueNDRangeKernel(*queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+	CheckOpenCLError(err, __LINE__);
+}
+
+// Enqueues the sort of buffers->keys[0] (and values[0]), every pass is histogram, scan of the counts and scatter
+void EnqueueSort(cl_command_queue *queue, cl_kernel *kernels, cl_kernel *sharedKernels, SortBuffers *buffers, size_t typeSize, int withValues)
+{
+	cl_uint passes = typeSize * 8 / RADIX_BITS;
+	cl_int err = CL_SUCCESS;
+
+	err |= clSetKernelArg(sharedKernels[REDUCECOUNTS], 0, sizeof(cl_mem), &buffers->counts);
+	err |= clSetKernelArg(sharedKernels[REDUCECOUNTS], 1, sizeof(cl_mem), &buffers->partials);
+	err |= clSetKernelArg(sharedKernels[REDUCECOUNTS], 2, sizeof(cl_uint), &buffers->numCounts);
+	err |= clSetKernelArg(sharedKernels[SCANPARTIALS], 0, sizeof(cl_mem), &buffers->partials);
+	err |= clSetKernelArg(sharedKernels[SCANPARTIALS], 1, sizeof(cl_uint), &buffers->numCountTiles);
+	err |= clSetKernelArg(sharedKernels[SCANCOUNTS], 0, sizeof(cl_mem), &buffers->counts);
+	err |= clSetKernelArg(sharedKernels[SCANCOUNTS], 1, sizeof(cl_mem), &buffers->partials);
+	err |= clSetKernelArg(sharedKernels[SCANCOUNTS], 2, sizeof(cl_uint), &buffers->numCounts);
+	CheckOpenCLError(err, __LINE__);
+
+	for (cl_uint pass = 0; pass < passes; pass++)
+	{
+		cl_uint shift = pass * RADIX_BITS;
+		int in = pass % 2;
+		int out = 1 - in;
+		cl_kernel scatter = withValues ? kernels[SCATTERPAIRS] : kernels[SCATTER];
+		cl_uint arg = 0;
+
+		err |= clSetKernelArg(kernels[HISTOGRAM], 0, sizeof(cl_mem), &buffers->keys[in]);
+		err |= clSetKernelArg(kernels[HISTOGRAM], 1, sizeof(cl_mem), &buffers->counts);
+		err |= clSetKernelArg(kernels[HISTOGRAM], 2, sizeof(cl_uint), &buffers->n);
+		err |= clSetKernelArg(kernels[HISTOGRAM], 3, sizeof(cl_uint), &shift);
+		err |= clSetKernelArg(kernels[HISTOGRAM], 4, sizeof(cl_uint), &buffers->numTiles);
+
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_mem), &buffers->keys[in]);
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_mem), &buffers->keys[out]);
+		if (withValues)
+		{
+			err |= clSetKernelArg(scatter, arg++, sizeof(cl_mem), &buffers->values[in]);
+			err |= clSetKernelArg(scatter, arg++, sizeof(cl_mem), &buffers->values[out]);
+		}
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_mem), &buffers->counts);
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_uint), &buffers->n);
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_uint), &shift);
+		err |= clSetKernelArg(scatter, arg++, sizeof(cl_uint), &buffers->numTiles);
+		CheckOpenCLError(err, __LINE__);
+
+		Launch(queue, kernels[HISTOGRAM], (size_t)buffers->numTiles * WG_SIZE);
+		Launch(queue, sharedKernels[REDUCECOUNTS], (size_t)buffers->numCountTiles * WG_SIZE);
+		Launch(queue, sharedKernels[SCANPARTIALS], WG_SIZE);
+		Launch(queue, sharedKernels[SCANCOUNTS], (size_t)buffers->numCountTiles * WG_SIZE);
+		Launch(queue, scatter, (size_t)buffers->numTiles * WG_SIZE);
+	}
+}
+
+// Checks on the device that keys[0] is sorted and, with values, that every key is the original key at the position
+// of its value. Returns the number of errors.
+cl_uint CheckSort(cl_command_queue *queue, cl_kernel *kernels, SortBuffers *buffers, int withValues)
+{
+	const cl_uint zero = 0;
+	cl_uint errors;
+	cl_int err;
+
+	err = clEnqueueFillBuffer(*queue, buffers->errors, &zero, sizeof(zero), 0, sizeof(cl_uint), 0, NULL, NULL);
+	err |= clSetKernelArg(kernels[CHECKSORTED], 0, sizeof(cl_mem), &buffers->keys[0]);
+	err |= clSetKernelArg(kernels[CHECKSORTED], 1, sizeof(cl_uint), &buffers->n);
+	err |= clSetKernelArg(kernels[CHECKSORTED], 2, sizeof(cl_mem), &buffers->errors);
+	CheckOpenCLError(err, __LINE__);
+	Launch(queue, kernels[CHECKSORTED], buffers->n);
+
+	if (withValues)
+	{
+		err |= clSetKernelArg(kernels[CHECKPAIRS], 0, sizeof(cl_mem), &buffers->keys[0]);
+		err |= clSetKernelArg(kernels[CHECKPAIRS], 1, sizeof(cl_mem), &buffers->values[0]);
+		err |= clSetKernelArg(kernels[CHECKPAIRS], 2, sizeof(cl_mem), &buffers->original);
+		err |= clSetKernelArg(kernels[CHECKPAIRS], 3, sizeof(cl_uint), &buffers->n);
+		err |= clSetKernelArg(kernels[CHECKPAIRS], 4, sizeof(cl_mem), &buffers->errors);
+		CheckOpenCLError(err, __LINE__);
+		Launch(queue, kernels[CHECKPAIRS], buffers->n);
+	}
+
+	err = clEnqueueReadBuffer(*queue, buffers->errors, CL_TRUE, 0, sizeof(cl_uint), &errors, 0, NULL, NULL);
+	CheckOpenCLError(err, __LINE__);
+	return errors;
+}
+
+// Sorts n random keys, 32-bit then 64-bit, keys only and with 32-bit values
+void RunSortTests(cl_context *context, cl_command_queue *queue, cl_kernel kernels[2][NUMSORTKERNELS], cl_kernel *sharedKernels, cl_uint n)
+{
+	const size_t typeSizes[2] = {sizeof(cl_uint), sizeof(cl_ulong)};
+	const char *suffixes[2] = {"32", "64"};
+	SortBuffers buffers;
+	char testName[64];
+	cl_int err;
+
+	void *keys = malloc((size_t)n * sizeof(cl_ulong));
+	if (keys == NULL)
+	{
+		printf("Not enough host memory for %u keys\n", n);
+		return;
+	}
+
+	buffers.n = n;
+	buffers.numTiles = (n + TILE - 1) / TILE;
+	buffers.numCounts = RADIX * buffers.numTiles;
+	buffers.numCountTiles = (buffers.numCounts + TILE - 1) / TILE;
+	buffers.original = clCreateBuffer(*context, CL_MEM_READ_ONLY, (size_t)n * sizeof(cl_ulong), NULL, &err);
+	for (int i = 0; i < 2; i++)
+	{
+		buffers.keys[i] = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_ulong), NULL, &err);
+		buffers.values[i] = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)n * sizeof(cl_uint), NULL, &err);
+	}
+	buffers.counts = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)buffers.numCounts * sizeof(cl_uint), NULL, &err);
+	buffers.partials = clCreateBuffer(*context, CL_MEM_READ_WRITE, (size_t)buffers.numCountTiles * sizeof(cl_uint), NULL, &err);
+	buffers.errors = clCreateBuffer(*context, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	for (int t = 0; t < 2; t++)
+	{
+		size_t bytes = (size_t)n * typeSizes[t];
+
+		// rand() may only give 15 bits, so several calls are combined
+		srand(t);
+		for (size_t i = 0; i < n; i++)
+		{
+			cl_ulong key = ((cl_ulong)rand() << 45) ^ ((cl_ulong)rand() << 30) ^ ((cl_ulong)rand() << 15) ^ (cl_ulong)rand();
+			if (t == 0)
+				((cl_uint *)keys)[i] = (cl_uint)key;
+			else
+				((cl_ulong *)keys)[i] = key;
+		}
+		err = clEnqueueWriteBuffer(*queue, buffers.original, CL_TRUE, 0, bytes, keys, 0, NULL, NULL);
+		CheckOpenCLError(err, __LINE__);
+
+		for (int withValues = 0; withValues < 2; withValues++)
+		{
+			double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+			cl_uint errors = 0;
+
+			snprintf(testName, sizeof(testName), "%s%s", withValues ? "sortPairs" : "sortKeys", suffixes[t]);
+
+			err = clSetKernelArg(sharedKernels[INITVALUES], 0, sizeof(cl_mem), &buffers.values[0]);
+			err |= clSetKernelArg(sharedKernels[INITVALUES], 1, sizeof(cl_uint), &n);
+			CheckOpenCLError(err, __LINE__);
+
+			// The first run is checked, the keys (and values) are reset before every run, outside of the timing
+			for (int k = 0; k <= NTIMES; k++)
+			{
+				err = clEnqueueCopyBuffer(*queue, buffers.original, buffers.keys[0], 0, 0, bytes, 0, NULL, NULL);
+				CheckOpenCLError(err, __LINE__);
+				if (withValues)
+					Launch(queue, sharedKernels[INITVALUES], n);
+				clFinish(*queue);
+
+				double time = GetWallTime();
+				EnqueueSort(queue, kernels[t], sharedKernels, &buffers, typeSizes[t], withValues);
+				clFinish(*queue);
+				time = GetWallTime() - time;
+
+				if (k == 0)
+				{
+					errors = CheckSort(queue, kernels[t], &buffers, withValues);
+					continue;
+				}
+
+				if (time < bestTime)
+				{
+					bestTime = time;
+				}
+				if (time > worstTime)
+				{
+					worstTime = time;
+				}
+				totalTime += time;
+
+#ifdef VERBOSE
+				printf("------------- %s run %2d, %9.3lf Mkeys/s\n", testName, k, n / 1.0e6 / time);
+#endif
+			}
+
+			if (errors)
+				printf("Error in %s, %u keys out of place\n", testName, errors);
+			printf("%-16s %10u   %6zu   %12.3lf   %8.6lf   %8.6lf   %8.6lf\n",
+				   testName, n, typeSizes[t] * 8 / RADIX_BITS, n / 1.0e6 / bestTime, totalTime / NTIMES, bestTime, worstTime);
+		}
+	}
+	printf("------------------------------------------------------------------------------------\n");
+
+	clReleaseMemObject(buffers.original);
+	for (int i = 0; i < 2; i++)
+	{
+		clReleaseMemObject(buffers.keys[i]);
+		clReleaseMemObject(buffers.values[i]);
+	}
+	clReleaseMemObject(buffers.counts);
+	clReleaseMemObject(buffers.partials);
+	clReleaseMemObject(buffers.errors);
+	free(keys);
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	char buildOptions[128];
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -DWG_SIZE=%d -DITEMS=%d -DRADIX_BITS=%d", WG_SIZE, ITEMS, RADIX_BITS);
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -0,0 +1,85 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Work-items per row in the CSR vector kernels, the work-group size. Set by the host with -D.
+// Must be a power of 2.
+#ifndef VECTOR_SIZE
+#define VECTOR_SIZE 64
+#endif
+
+// y = A * x. CSR matrices have rows + 1 row pointers, ELL matrices are stored column major
+// (the k-th element of every row together), rows padded to the same width with zeros.
+#define SPMV_KERNELS(TYPENAME, TYPE)                                                        \
+                                                                                           \
+/* One row per work-item */                                                                \
+__kernel void spmvCsrScalar##TYPENAME(__global const uint * restrict rowPtr,               \
+                                      __global const uint * restrict colIdx,               \
+                                      __global const TYPE * restrict values,               \
+                                      __global const TYPE * restrict x,                    \
+                                      __global TYPE * restrict y,                          \
+                                      const uint rows)                                     \
+{                                                                                          \
+	size_t row = get_global_id(0);                                                         \
+                                                                                           \
+	if (row < rows)                                                                        \
+	{                                                                                      \
+		TYPE sum = 0;                                                                      \
+		for (uint j = rowPtr[row]; j < rowPtr[row + 1]; j++)                               \
+			sum += values[j] * x[colIdx[j]];                                               \
+		y[row] = sum;                                                                      \
+	}                                                                                      \
+}                                                                                          \
+                                                                                           \
+/* One work-group of VECTOR_SIZE work-items per row, reduced in local memory */            \
+__kernel void spmvCsrVector##TYPENAME(__global const uint * restrict rowPtr,               \
+                                      __global const uint * restrict colIdx,               \
+                                      __global const TYPE * restrict values,               \
+                                      __global const TYPE * restrict x,                    \
+                                      __global TYPE * restrict y,                          \
+                                      const uint rows)                                     \
+{                                                                                          \
+	__local TYPE partial[VECTOR_SIZE];                                                     \
+	size_t row = get_group_id(0);                                                          \
+	uint lid = get_local_id(0);                                                            \
+	TYPE sum = 0;                                                                          \
+                                                                                           \
+	for (uint j = rowPtr[row] + lid; j < rowPtr[row + 1]; j += VECTOR_SIZE)                \
+		sum += values[j] * x[colIdx[j]];                                                   \
+	partial[lid] = sum;                                                                    \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	for (uint s = VECTOR_SIZE / 2; s > 0; s /= 2)                                          \
+	{                                                                                      \
+		if (lid < s)                                                                       \
+			partial[lid] += partial[lid + s];                                              \
+		barrier(CLK_LOCAL_MEM_FENCE);                                                      \
+	}                                                                                      \
+                                                                                           \
+	if (lid == 0)                                                                          \
+		y[row] = partial[0];                                                               \
+}                                                                                          \
+                                                                                           \
+/* One row per work-item, consecutive work-items read consecutive elements */              \
+__kernel void spmvEll##TYPENAME(__global const uint * restrict colIdx,                     \
+                                __global const TYPE * restrict values,                     \
+                                __global const TYPE * restrict x,                          \
+                                __global TYPE * restrict y,                                \
+                                const uint rows,                                           \
+                                const uint width)                                          \
+{                                                                                          \
+	size_t row = get_global_id(0);                                                         \
+                                                                                           \
+	if (row < rows)                                                                        \
+	{                                                                                      \
+		TYPE sum = 0;                                                                      \
+		for (uint k = 0; k < width; k++)                                                   \
+			sum += values[(size_t)k * rows + row] * x[colIdx[(size_t)k * rows + row]];     \
+		y[row] = sum;                                                                      \
+	}                                                                                      \
+}
+
+// spmvCsrScalarDouble, spmvCsrVectorDouble, spmvEllDouble, ...
+SPMV_KERNELS(Double, double)
+SPMV_KERNELS(Float, float)
@@ -0,0 +1,970 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Synthetic matrices are square, SPMVROWS x SPMVROWS
+#define SPMVROWS (1024 * 1024)
+
+// Banded: BANDWIDTH non-zeros per row around the diagonal
+#define BANDWIDTH 27
+
+// Uniform random: RANDOMNNZ non-zeros per row, in random columns
+#define RANDOMNNZ 16
+
+// Power-law: row lengths POWERLAWMIN / u, u uniform in (0, 1], capped at POWERLAWMAX
+#define POWERLAWMIN 4
+#define POWERLAWMAX 4096
+
+// ELL is skipped when the padding would make it more than ELLMAXFILL times the non-zeros
+#define ELLMAXFILL 3
+
+// Work-items per row in the CSR vector kernels, passed to kernels.cl at build time
+#define VECTOR_SIZE 64
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-local-size results during test?
+// #define VERBOSE
+
+// Square or rectangular sparse matrix, CSR with double values
+typedef struct
+{
+	size_t rows, cols, nnz;
+	cl_uint *rowPtr; // rows + 1
+	cl_uint *colIdx; // nnz
+	double *values;  // nnz
+} CsrMatrix;
+
+// Function prototypes
+double GetWallTime(void);
+void GenerateBanded(CsrMatrix *matrix, size_t rows, size_t band);
+void GenerateRandom(CsrMatrix *matrix, size_t rows, size_t nnzPerRow);
+void GeneratePowerLaw(CsrMatrix *matrix, size_t rows, size_t minLength, size_t maxLength);
+int ReadMatrixMarket(CsrMatrix *matrix, const char *fileName);
+void FreeMatrix(CsrMatrix *matrix);
+void RunSpmvTests(cl_context *context, cl_command_queue *queue, cl_program *program, CsrMatrix *matrix, char *matrixName);
+void RunSpmvTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, char *matrixName, CsrMatrix *matrix, size_t itemsPerRow,
+				 size_t fixedLocalSize, size_t bytes, size_t dataType, cl_mem *y, const double *reference);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(int argc, char *argv[])
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+	CsrMatrix         matrix;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	// GFLOPS count 2 flops per non-zero. GB/s count every matrix element, row pointer, x and y once.
+	printf("-----------------------------------------------------------------------------------------------------------------------------------\n");
+	printf("Function         Matrix            Rows        Non-zeros   Best GFLOPS   Best Rate GB/s   Avg time   Min time   Best Workgroup Size\n");
+	printf("-----------------------------------------------------------------------------------------------------------------------------------\n");
+
+	// If the user gives a Matrix Market file, it is used instead of the synthetic matrices
+	if (argc == 2)
+	{
+		if (ReadMatrixMarket(&matrix, argv[1]) == EXIT_FAILURE)
+		{
+			CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+			return EXIT_FAILURE;
+		}
+		const char *baseName = strrchr(argv[1], '/');
+		RunSpmvTests(&context, &queue, &program, &matrix, (char *)(baseName ? baseName + 1 : argv[1]));
+		FreeMatrix(&matrix);
+	}
+	else
+	{
+		GenerateBanded(&matrix, SPMVROWS, BANDWIDTH);
+		RunSpmvTests(&context, &queue, &program, &matrix, "banded");
+		FreeMatrix(&matrix);
+
+		GenerateRandom(&matrix, SPMVROWS, RANDOMNNZ);
+		RunSpmvTests(&context, &queue, &program, &matrix, "random");
+		FreeMatrix(&matrix);
+
+		GeneratePowerLaw(&matrix, SPMVROWS, POWERLAWMIN, POWERLAWMAX);
+		RunSpmvTests(&context, &queue, &program, &matrix, "powerlaw");
+		FreeMatrix(&matrix);
+	}
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Random values in [0.5, 1.5), so sums don't cancel and the relative error stays meaningful
+static double RandomValue(void)
+{
+	return 0.5 + (double)rand() / ((double)RAND_MAX + 1.0);
+}
+
+// Random column in [0, cols). rand() may only give 15 bits, so two calls are combined.
+static cl_uint RandomColumn(size_t cols)
+{
+	return (cl_uint)((((size_t)rand() << 15) ^ (size_t)rand()) % cols);
+}
+
+// Allocates the arrays once the row lengths are in rowPtr[1..rows], and turns them into offsets
+static void AllocateFromRowLengths(CsrMatrix *matrix)
+{
+	matrix->rowPtr[0] = 0;
+	for (size_t i = 0; i < matrix->rows; i++)
+		matrix->rowPtr[i + 1] += matrix->rowPtr[i];
+	matrix->nnz = matrix->rowPtr[matrix->rows];
+	matrix->colIdx = malloc(matrix->nnz * sizeof(cl_uint));
+	matrix->values = malloc(matrix->nnz * sizeof(double));
+}
+
+void GenerateBanded(CsrMatrix *matrix, size_t rows, size_t band)
+{
+	matrix->rows = matrix->cols = rows;
+	matrix->rowPtr = calloc(rows + 1, sizeof(cl_uint));
+
+	// The band is cut at the first and last rows
+	for (size_t i = 0; i < rows; i++)
+	{
+		long first = (long)i - (long)band / 2, last = first + (long)band - 1;
+		if (first < 0)
+			first = 0;
+		if (last > (long)rows - 1)
+			last = (long)rows - 1;
+		matrix->rowPtr[i + 1] = last - first + 1;
+	}
+	AllocateFromRowLengths(matrix);
+
+	srand(0);
+	for (size_t i = 0; i < rows; i++)
+	{
+		long first = (long)i - (long)band / 2;
+		if (first < 0)
+			first = 0;
+		for (cl_uint j = matrix->rowPtr[i]; j < matrix->rowPtr[i + 1]; j++)
+		{
+			matrix->colIdx[j] = first + (j - matrix->rowPtr[i]);
+			matrix->values[j] = RandomValue();
+		}
+	}
+}
+
+void GenerateRandom(CsrMatrix *matrix, size_t rows, size_t nnzPerRow)
+{
+	matrix->rows = matrix->cols = rows;
+	matrix->rowPtr = calloc(rows + 1, sizeof(cl_uint));
+	for (size_t i = 0; i < rows; i++)
+		matrix->rowPtr[i + 1] = nnzPerRow;
+	AllocateFromRowLengths(matrix);
+
+	srand(1);
+	for (size_t j = 0; j < matrix->nnz; j++)
+	{
+		matrix->colIdx[j] = RandomColumn(matrix->cols);
+		matrix->values[j] = RandomValue();
+	}
+}
+
+void GeneratePowerLaw(CsrMatrix *matrix, size_t rows, size_t minLength, size_t maxLength)
+{
+	matrix->rows = matrix->cols = rows;
+	matrix->rowPtr = calloc(rows + 1, sizeof(cl_uint));
+
+	srand(2);
+	for (size_t i = 0; i < rows; i++)
+	{
+		double u = ((double)rand() + 1.0) / ((double)RAND_MAX + 1.0);
+		size_t length = (size_t)(minLength / u);
+		matrix->rowPtr[i + 1] = (length > maxLength) ? maxLength : length;
+	}
+	AllocateFromRowLengths(matrix);
+
+	for (size_t j = 0; j < matrix->nnz; j++)
+	{
+		matrix->colIdx[j] = RandomColumn(matrix->cols);
+		matrix->values[j] = RandomValue();
+	}
+}
+
+// Reads a real, integer or pattern coordinate Matrix Market file, general or symmetric
+int ReadMatrixMarket(CsrMatrix *matrix, const char *fileName)
+{
+	char line[1024], object[32], format[32], field[32], symmetry[32];
+	size_t rows, cols, entries;
+
+	FILE *file = fopen(fileName, "r");
+	if (file == NULL)
+	{
+		printf("Error opening Matrix Market file %s\n", fileName);
+		return EXIT_FAILURE;
+	}
+
+	if (fgets(line, sizeof(line), file) == NULL ||
+		sscanf(line, "%%%%MatrixMarket %31s %31s %31s %31s", object, format, field, symmetry) != 4 ||
+		strcmp(object, "matrix") != 0 || strcmp(format, "coordinate") != 0 || strcmp(field, "complex") == 0)
+	{
+		printf("Error in %s, only real, integer or pattern coordinate matrices are supported\n", fileName);
+		fclose(file);
+		return EXIT_FAILURE;
+	}
+	int pattern = strcmp(field, "pattern") == 0;
+	int symmetric = strcmp(symmetry, "general") != 0;
+	double mirrorSign = strcmp(symmetry, "skew-symmetric") == 0 ? -1.0 : 1.0; // a(j, i) = -a(i, j)
+
+	// Skip the comments, then the size line
+	do
+	{
+		if (fgets(line, sizeof(line), file) == NULL)
+		{
+			printf("Error in %s, no size line\n", fileName);
+			fclose(file);
+			return EXIT_FAILURE;
+		}
+	} while (line[0] == '%');
+	if (sscanf(line, "%zu %zu %zu", &rows, &cols, &entries) != 3 || rows == 0 || cols == 0 || (symmetric && rows != cols))
+	{
+		printf("Error in %s, malformed size line (symmetric matrices must be square)\n", fileName);
+		fclose(file);
+		return EXIT_FAILURE;
+	}
+
+	// Read the entries as coordinates, mirroring the off diagonal ones of symmetric (negated for skew-symmetric) matrices
+	size_t maxEntries = symmetric ? 2 * entries : entries;
+	cl_uint *entryRow = malloc(maxEntries * sizeof(cl_uint));
+	cl_uint *entryCol = malloc(maxEntries * sizeof(cl_uint));
+	double *entryValue = malloc(maxEntries * sizeof(double));
+	size_t n = 0;
+
+	for (size_t e = 0; e < entries; e++)
+	{
+		size_t i, j;
+		double value = 1.0;
+		if (fgets(line, sizeof(line), file) == NULL ||
+			sscanf(line, "%zu %zu %lf", &i, &j, &value) < (pattern ? 2 : 3) ||
+			i < 1 || i > rows || j < 1 || j > cols)
+		{
+			printf("Error in %s, entry %zu is missing, malformed or out of the matrix\n", fileName, e);
+			free(entryRow);
+			free(entryCol);
+			free(entryValue);
+			fclose(file);
+			return EXIT_FAILURE;
+		}
+		entryRow[n] = i - 1;
+		entryCol[n] = j - 1;
+		entryValue[n++] = value;
+		if (symmetric && i != j)
+		{
+			entryRow[n] = j - 1;
+			entryCol[n] = i - 1;
+			entryValue[n++] = mirrorSign * value;
+		}
+	}
+	fclose(file);
+
+	// Coordinates to CSR, counting the entries per row first
+	matrix->rows = rows;
+	matrix->cols = cols;
+	matrix->rowPtr = calloc(rows + 1, sizeof(cl_uint));
+	for (size_t e = 0; e < n; e++)
+		matrix->rowPtr[entryRow[e] + 1]++;
+	AllocateFromRowLengths(matrix);
+
+	cl_uint *next = malloc(rows * sizeof(cl_uint));
+	memcpy(next, matrix->rowPtr, rows * sizeof(cl_uint));
+	for (size_t e = 0; e < n; e++)
+	{
+		cl_uint j = next[entryRow[e]]++;
+		matrix->colIdx[j] = entryCol[e];
+		matrix->values[j] = entryValue[e];
+	}
+
+	free(next);
+	free(entryRow);
+	free(entryCol);
+	free(entryValue);
+	return EXIT_SUCCESS;
+}
+
+void FreeMatrix(CsrMatrix *matrix)
+{
+	free(matrix->rowPtr);
+	free(matrix->colIdx);
+	free(matrix->values);
+}
+
+// Runs the CSR scalar, CSR vector and ELL kernels on the matrix, for Doubles and Floats,
+// checking them against a host CSR product in double precision
+void RunSpmvTests(cl_context *context, cl_command_queue *queue, cl_program *program, CsrMatrix *matrix, char *matrixName)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const char *typeLetters[] = {"D", "F"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	size_t rows = matrix->rows, cols = matrix->cols, nnz = matrix->nnz;
+	cl_uint rowsArg = rows;
+	char kernelName[64];
+	char testName[64];
+	cl_kernel kernel;
+	cl_int err;
+
+	// x is random, the reference is computed once in double
+	double *x = malloc(cols * sizeof(double));
+	double *reference = malloc(rows * sizeof(double));
+	srand(3);
+	for (size_t i = 0; i < cols; i++)
+		x[i] = RandomValue();
+	for (size_t i = 0; i < rows; i++)
+	{
+		reference[i] = 0.0;
+		for (cl_uint j = matrix->rowPtr[i]; j < matrix->rowPtr[i + 1]; j++)
+			reference[i] += matrix->values[j] * x[matrix->colIdx[j]];
+	}
+
+	// ELL width is the longest row, padded entries point at column 0 with a value of 0
+	size_t ellWidth = 0;
+	for (size_t i = 0; i < rows; i++)
+	{
+		if (matrix->rowPtr[i + 1] - matrix->rowPtr[i] > ellWidth)
+			ellWidth = matrix->rowPtr[i + 1] - matrix->rowPtr[i];
+	}
+	int runEll = ellWidth * rows <= ELLMAXFILL * nnz;
+	cl_uint ellWidthArg = ellWidth;
+
+	for (int p = 0; p < 2; p++)
+	{
+		size_t typeSize = typeSizes[p];
+
+		// Values of the right precision for the device
+		void *values = malloc(nnz * typeSize);
+		void *xTyped = malloc(cols * typeSize);
+		for (size_t j = 0; j < nnz; j++)
+		{
+			if (p == 0)
+				((double *)values)[j] = matrix->values[j];
+			else
+				((float *)values)[j] = (float)matrix->values[j];
+		}
+		for (size_t i = 0; i < cols; i++)
+		{
+			if (p == 0)
+				((double *)xTyped)[i] = x[i];
+			else
+				((float *)xTyped)[i] = (float)x[i];
+		}
+
+		cl_mem rowPtrBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, (rows + 1) * sizeof(cl_uint), matrix->rowPtr, &err);
+		cl_mem colIdxBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, nnz * sizeof(cl_uint), matrix->colIdx, &err);
+		cl_mem valuesBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, nnz * typeSize, values, &err);
+		cl_mem xBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, cols * typeSize, xTyped, &err);
+		cl_mem yBuffer = clCreateBuffer(*context, CL_MEM_WRITE_ONLY, rows * typeSize, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+
+		// Matrix, row pointers, x and y, each once
+		size_t csrBytes = nnz * (typeSize + sizeof(cl_uint)) + (rows + 1) * sizeof(cl_uint) + cols * typeSize + rows * typeSize;
+
+		for (int v = 0; v < 2; v++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "spmvCsr%s%s", v == 0 ? "Scalar" : "Vector", precisions[p]);
+			snprintf(testName, sizeof(testName), "csr%s%s", v == 0 ? "Scalar" : "Vector", typeLetters[p]);
+			kernel = clCreateKernel(*program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+			err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &rowPtrBuffer);
+			err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &colIdxBuffer);
+			err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &valuesBuffer);
+			err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &xBuffer);
+			err |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &yBuffer);
+			err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &rowsArg);
+			CheckOpenCLError(err, __LINE__);
+
+			// The vector kernel has a fixed work-group of VECTOR_SIZE per row
+			RunSpmvTest(queue, &kernel, testName, matrixName, matrix, v == 0 ? 1 : VECTOR_SIZE, v == 0 ? 0 : VECTOR_SIZE,
+						csrBytes, typeSize, &yBuffer, reference);
+			clReleaseKernel(kernel);
+		}
+
+		if (runEll)
+		{
+			// Column major, every row padded to ellWidth
+			cl_uint *ellColIdx = calloc(ellWidth * rows, sizeof(cl_uint));
+			void *ellValues = calloc(ellWidth * rows, typeSize);
+			for (size_t i = 0; i < rows; i++)
+			{
+				for (cl_uint j = matrix->rowPtr[i]; j < matrix->rowPtr[i + 1]; j++)
+				{
+					size_t k = j - matrix->rowPtr[i];
+					ellColIdx[k * rows + i] = matrix->colIdx[j];
+					if (p == 0)
+						((double *)ellValues)[k * rows + i] = matrix->values[j];
+					else
+						((float *)ellValues)[k * rows + i] = (float)matrix->values[j];
+				}
+			}
+
+			cl_mem ellColIdxBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, ellWidth * rows * sizeof(cl_uint), ellColIdx, &err);
+			cl_mem ellValuesBuffer = clCreateBuffer(*context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, ellWidth * rows * typeSize, ellValues, &err);
+			CheckOpenCLError(err, __LINE__);
+
+			snprintf(kernelName, sizeof(kernelName), "spmvEll%s", precisions[p]);
+			snprintf(testName, sizeof(testName), "ell%s", typeLetters[p]);
+			kernel = clCreateKernel(*program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+			err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &ellColIdxBuffer);
+			err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &ellValuesBuffer);
+			err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &xBuffer);
+			err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &yBuffer);
+			err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &rowsArg);
+			err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &ellWidthArg);
+			CheckOpenCLError(err, __LINE__);
+
+			// Bandwidth counts the padded matrix too, it is all read
+			size_t ellBytes = ellWidth * rows * (typeSize + sizeof(cl_uint)) + cols * typeSize + rows * typeSize;
+			RunSpmvTest(queue, &kernel, testName, matrixName, matrix, 1, 0, ellBytes, typeSize, &yBuffer, reference);
+
+			clReleaseKernel(kernel);
+			clReleaseMemObject(ellColIdxBuffer);
+			clReleaseMemObject(ellValuesBuffer);
+			free(ellColIdx);
+			free(ellValues);
+		}
+		else
+		{
+			printf("ell%s             %-10s   skipped, padding to %zu per row would store %.1fx the non-zeros\n",
+				   typeLetters[p], matrixName, ellWidth, (double)ellWidth * rows / nnz);
+		}
+		printf("-----------------------------------------------------------------------------------------------------------------------------------\n");
+
+		clReleaseMemObject(rowPtrBuffer);
+		clReleaseMemObject(colIdxBuffer);
+		clReleaseMemObject(valuesBuffer);
+		clReleaseMemObject(xBuffer);
+		clReleaseMemObject(yBuffer);
+		free(values);
+		free(xTyped);
+	}
+
+	free(x);
+	free(reference);
+}
+
+// Runs the kernel NTIMES with itemsPerRow work-items per row, for every local size from 16 to 256
+// or only fixedLocalSize when it is not 0. y is checked against the reference after the first launch.
+void RunSpmvTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, char *matrixName, CsrMatrix *matrix, size_t itemsPerRow,
+				 size_t fixedLocalSize, size_t bytes, size_t dataType, cl_mem *y, const double *reference)
+{
+	size_t localSize;
+	size_t bestLocalSize = 0;
+	double bestTime = DBL_MAX, totalTime = 0.0;
+	int numRuns = 0;
+	cl_int err;
+
+	for (localSize = 16; localSize <= 256; localSize *= 2)
+	{
+		if (fixedLocalSize != 0)
+			localSize = fixedLocalSize;
+
+		// Round the rows up to the local size, the kernels skip the extra work-items
+		size_t globalSize = matrix->rows * itemsPerRow;
+		if (globalSize % localSize != 0)
+			globalSize += localSize - globalSize % localSize;
+
+		if (numRuns == 0)
+		{
+			err = clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+			CheckOpenCLError(err, __LINE__);
+
+			// Floats add up to POWERLAWMAX terms in a different order than the host
+			double epsilon = (dataType == sizeof(double)) ? 1e-10 : 1e-4;
+			void *result = malloc(matrix->rows * dataType);
+			clEnqueueReadBuffer(*queue, *y, CL_TRUE, 0, matrix->rows * dataType, result, 0, NULL, NULL);
+			for (size_t i = 0; i < matrix->rows; i++)
+			{
+				double r = (dataType == sizeof(double)) ? ((double *)result)[i] : ((float *)result)[i];
+				double scale = (fabs(reference[i]) > 1.0) ? fabs(reference[i]) : 1.0;
+				if (fabs(r - reference[i]) > epsilon * scale)
+				{
+					printf("Error in %s, row %zu is %e, expected %e\n", testName, i, r, reference[i]);
+					break;
+				}
+			}
+			free(result);
+		}
+
+		double time = GetWallTime();
+
+		for (int n = 0; n < NTIMES; n++)
+		{
+			err = clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+		}
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		time = GetWallTime() - time;
+		if (time < bestTime)
+		{
+			bestTime = time;
+			bestLocalSize = localSize;
+		}
+		totalTime += time;
+		numRuns++;
+
+#ifdef VERBOSE
+		printf("------------- localSize = %3zu, %7.3lf GFLOPS\n", localSize, 2.0 * NTIMES * matrix->nnz / 1.0e9 / time);
+#endif
+
+		if (fixedLocalSize != 0)
+			break;
+	}
+
+	printf("%-14s   %-10s   %9zu   %14zu   %11.3lf   %14.3lf   %8.6lf   %8.6lf   %19zu\n",
+		   testName, matrixName, matrix->rows, matrix->nnz, 2.0 * NTIMES * matrix->nnz / 1.0e9 / bestTime,
+		   NTIMES * bytes / 1024.0 / 1024.0 / 1024.0 / bestTime, totalTime / (NTIMES * numRuns), bestTime / NTIMES, bestLocalSize);
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program, the host sets the work-group size of the CSR vector kernels
+	char buildOptions[128];
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -DVECTOR_SIZE=%d", VECTOR_SIZE);
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -0,0 +1,274 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Work-group shapes and register blocking, set by the host with -D.
+// 2-D kernels use TILE_X x TILE_Y work-groups, 3-D kernels TILE3D_X x TILE3D_Y x TILE3D_Z.
+// Register-blocked kernels compute REGBLOCK points along y (2-D) or z (3-D) per work-item.
+#ifndef TILE_X
+#define TILE_X 32
+#endif
+#ifndef TILE_Y
+#define TILE_Y 8
+#endif
+#ifndef TILE3D_X
+#define TILE3D_X 32
+#endif
+#ifndef TILE3D_Y
+#define TILE3D_Y 4
+#endif
+#ifndef TILE3D_Z
+#define TILE3D_Z 2
+#endif
+#ifndef REGBLOCK
+#define REGBLOCK 8
+#endif
+
+// Jacobi stencils, out = weight * (sum of the points). Boundary points are copied.
+// The points are always added in the same order, which the host reference follows:
+// 5-point: center, x-1, x+1, y-1, y+1
+// 9-point: rows y-1, y, y+1, each x-1, x, x+1
+// 7-point: center, x-1, x+1, y-1, y+1, z-1, z+1
+
+// Local tiles have a halo of 1. They are loaded by the whole work-group, one element
+// per work-item at a time, clamping the reads at the borders of the grid.
+#define LOAD_TILE_2D(tile, in, width, height)                                                \
+	for (int i = get_local_id(1) * TILE_X + get_local_id(0); i < (TILE_X + 2) * (TILE_Y + 2); i += TILE_X * TILE_Y) \
+	{                                                                                        \
+		int tx = i % (TILE_X + 2), ty = i / (TILE_X + 2);                                    \
+		int gx = clamp((int)(get_group_id(0) * TILE_X) + tx - 1, 0, (int)width - 1);         \
+		int gy = clamp((int)(get_group_id(1) * TILE_Y) + ty - 1, 0, (int)height - 1);        \
+		tile[ty][tx] = in[(size_t)gy * width + gx];                                          \
+	}                                                                                        \
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+#define STENCIL_2D_KERNELS(TYPENAME, TYPE)                                                  \
+                                                                                           \
+__kernel void jacobi5Naive##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint width,                                     \
+                                     const uint height,                                    \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	size_t idx = y * width + x;                                                            \
+                                                                                           \
+	if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                             \
+		out[idx] = in[idx];                                                                \
+	else                                                                                   \
+		out[idx] = weight * (in[idx] + in[idx - 1] + in[idx + 1] + in[idx - width] + in[idx + width]); \
+}                                                                                          \
+                                                                                           \
+__kernel void jacobi5Local##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint width,                                     \
+                                     const uint height,                                    \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	__local TYPE tile[TILE_Y + 2][TILE_X + 2];                                             \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	int lx = get_local_id(0) + 1;                                                          \
+	int ly = get_local_id(1) + 1;                                                          \
+                                                                                           \
+	LOAD_TILE_2D(tile, in, width, height)                                                  \
+                                                                                           \
+	if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                             \
+		out[y * width + x] = tile[ly][lx];                                                 \
+	else                                                                                   \
+		out[y * width + x] = weight * (tile[ly][lx] + tile[ly][lx - 1] + tile[ly][lx + 1] + tile[ly - 1][lx] + tile[ly + 1][lx]); \
+}                                                                                          \
+                                                                                           \
+/* Every work-item goes down REGBLOCK rows, keeping the rows above and below in registers */ \
+__kernel void jacobi5RegBlock##TYPENAME(__global const TYPE * restrict in,                 \
+                                        __global TYPE * restrict out,                      \
+                                        const uint width,                                  \
+                                        const uint height,                                 \
+                                        const TYPE weight)                                 \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y0 = get_global_id(1) * REGBLOCK;                                               \
+	size_t xw = (x > 0) ? x - 1 : x;                                                       \
+	size_t xe = (x < width - 1) ? x + 1 : x;                                               \
+	TYPE up = in[((y0 > 0) ? y0 - 1 : y0) * width + x];                                    \
+	TYPE center = in[y0 * width + x];                                                      \
+                                                                                           \
+	for (int j = 0; j < REGBLOCK; j++)                                                     \
+	{                                                                                      \
+		size_t y = y0 + j;                                                                 \
+		TYPE down = in[((y < height - 1) ? y + 1 : y) * width + x];                        \
+		if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                         \
+			out[y * width + x] = center;                                                   \
+		else                                                                               \
+			out[y * width + x] = weight * (center + in[y * width + xw] + in[y * width + xe] + up + down); \
+		up = center;                                                                       \
+		center = down;                                                                     \
+	}                                                                                      \
+}                                                                                          \
+                                                                                           \
+__kernel void jacobi9Naive##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint width,                                     \
+                                     const uint height,                                    \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	size_t idx = y * width + x;                                                            \
+                                                                                           \
+	if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                             \
+		out[idx] = in[idx];                                                                \
+	else                                                                                   \
+		out[idx] = weight * (in[idx - width - 1] + in[idx - width] + in[idx - width + 1] + \
+		                     in[idx - 1] + in[idx] + in[idx + 1] +                         \
+		                     in[idx + width - 1] + in[idx + width] + in[idx + width + 1]); \
+}                                                                                          \
+                                                                                           \
+__kernel void jacobi9Local##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint width,                                     \
+                                     const uint height,                                    \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	__local TYPE tile[TILE_Y + 2][TILE_X + 2];                                             \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	int lx = get_local_id(0) + 1;                                                          \
+	int ly = get_local_id(1) + 1;                                                          \
+                                                                                           \
+	LOAD_TILE_2D(tile, in, width, height)                                                  \
+                                                                                           \
+	if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                             \
+		out[y * width + x] = tile[ly][lx];                                                 \
+	else                                                                                   \
+		out[y * width + x] = weight * (tile[ly - 1][lx - 1] + tile[ly - 1][lx] + tile[ly - 1][lx + 1] + \
+		                               tile[ly][lx - 1] + tile[ly][lx] + tile[ly][lx + 1] + \
+		                               tile[ly + 1][lx - 1] + tile[ly + 1][lx] + tile[ly + 1][lx + 1]); \
+}                                                                                          \
+                                                                                           \
+/* Same as jacobi5RegBlock, with a 3x3 window of registers */                              \
+__kernel void jacobi9RegBlock##TYPENAME(__global const TYPE * restrict in,                 \
+                                        __global TYPE * restrict out,                      \
+                                        const uint width,                                  \
+                                        const uint height,                                 \
+                                        const TYPE weight)                                 \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y0 = get_global_id(1) * REGBLOCK;                                               \
+	size_t xw = (x > 0) ? x - 1 : x;                                                       \
+	size_t xe = (x < width - 1) ? x + 1 : x;                                               \
+	size_t yu = (y0 > 0) ? y0 - 1 : y0;                                                    \
+	TYPE upW = in[yu * width + xw], up = in[yu * width + x], upE = in[yu * width + xe];    \
+	TYPE centerW = in[y0 * width + xw], center = in[y0 * width + x], centerE = in[y0 * width + xe]; \
+                                                                                           \
+	for (int j = 0; j < REGBLOCK; j++)                                                     \
+	{                                                                                      \
+		size_t y = y0 + j;                                                                 \
+		size_t yd = (y < height - 1) ? y + 1 : y;                                          \
+		TYPE downW = in[yd * width + xw], down = in[yd * width + x], downE = in[yd * width + xe]; \
+		if (x == 0 || y == 0 || x == width - 1 || y == height - 1)                         \
+			out[y * width + x] = center;                                                   \
+		else                                                                               \
+			out[y * width + x] = weight * (upW + up + upE + centerW + center + centerE + downW + down + downE); \
+		upW = centerW; up = center; upE = centerE;                                         \
+		centerW = downW; center = down; centerE = downE;                                   \
+	}                                                                                      \
+}
+
+#define STENCIL_3D_KERNELS(TYPENAME, TYPE)                                                  \
+                                                                                           \
+__kernel void jacobi7Naive##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint nx,                                        \
+                                     const uint ny,                                        \
+                                     const uint nz,                                        \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	size_t z = get_global_id(2);                                                           \
+	size_t plane = (size_t)nx * ny;                                                        \
+	size_t idx = z * plane + y * nx + x;                                                   \
+                                                                                           \
+	if (x == 0 || y == 0 || z == 0 || x == nx - 1 || y == ny - 1 || z == nz - 1)           \
+		out[idx] = in[idx];                                                                \
+	else                                                                                   \
+		out[idx] = weight * (in[idx] + in[idx - 1] + in[idx + 1] + in[idx - nx] + in[idx + nx] + \
+		                     in[idx - plane] + in[idx + plane]);                           \
+}                                                                                          \
+                                                                                           \
+__kernel void jacobi7Local##TYPENAME(__global const TYPE * restrict in,                    \
+                                     __global TYPE * restrict out,                         \
+                                     const uint nx,                                        \
+                                     const uint ny,                                        \
+                                     const uint nz,                                        \
+                                     const TYPE weight)                                    \
+{                                                                                          \
+	__local TYPE tile[TILE3D_Z + 2][TILE3D_Y + 2][TILE3D_X + 2];                           \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	size_t z = get_global_id(2);                                                           \
+	int lx = get_local_id(0) + 1;                                                          \
+	int ly = get_local_id(1) + 1;                                                          \
+	int lz = get_local_id(2) + 1;                                                          \
+	int lid = (get_local_id(2) * TILE3D_Y + get_local_id(1)) * TILE3D_X + get_local_id(0); \
+                                                                                           \
+	for (int i = lid; i < (TILE3D_X + 2) * (TILE3D_Y + 2) * (TILE3D_Z + 2); i += TILE3D_X * TILE3D_Y * TILE3D_Z) \
+	{                                                                                      \
+		int tx = i % (TILE3D_X + 2);                                                       \
+		int ty = (i / (TILE3D_X + 2)) % (TILE3D_Y + 2);                                    \
+		int tz = i / ((TILE3D_X + 2) * (TILE3D_Y + 2));                                    \
+		int gx = clamp((int)(get_group_id(0) * TILE3D_X) + tx - 1, 0, (int)nx - 1);        \
+		int gy = clamp((int)(get_group_id(1) * TILE3D_Y) + ty - 1, 0, (int)ny - 1);        \
+		int gz = clamp((int)(get_group_id(2) * TILE3D_Z) + tz - 1, 0, (int)nz - 1);        \
+		tile[tz][ty][tx] = in[((size_t)gz * ny + gy) * nx + gx];                           \
+	}                                                                                      \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	size_t idx = (z * ny + y) * nx + x;                                                    \
+	if (x == 0 || y == 0 || z == 0 || x == nx - 1 || y == ny - 1 || z == nz - 1)           \
+		out[idx] = tile[lz][ly][lx];                                                       \
+	else                                                                                   \
+		out[idx] = weight * (tile[lz][ly][lx] + tile[lz][ly][lx - 1] + tile[lz][ly][lx + 1] + \
+		                     tile[lz][ly - 1][lx] + tile[lz][ly + 1][lx] +                 \
+		                     tile[lz - 1][ly][lx] + tile[lz + 1][ly][lx]);                 \
+}                                                                                          \
+                                                                                           \
+/* Every work-item goes up REGBLOCK planes, keeping the points below and above in registers */ \
+__kernel void jacobi7RegBlock##TYPENAME(__global const TYPE * restrict in,                 \
+                                        __global TYPE * restrict out,                      \
+                                        const uint nx,                                     \
+                                        const uint ny,                                     \
+                                        const uint nz,                                     \
+                                        const TYPE weight)                                 \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+	size_t z0 = get_global_id(2) * REGBLOCK;                                               \
+	size_t plane = (size_t)nx * ny;                                                        \
+	size_t column = y * nx + x;                                                            \
+	int xyBoundary = (x == 0 || y == 0 || x == nx - 1 || y == ny - 1);                     \
+	TYPE below = in[((z0 > 0) ? z0 - 1 : z0) * plane + column];                            \
+	TYPE center = in[z0 * plane + column];                                                 \
+                                                                                           \
+	for (int k = 0; k < REGBLOCK; k++)                                                     \
+	{                                                                                      \
+		size_t z = z0 + k;                                                                 \
+		size_t idx = z * plane + column;                                                   \
+		TYPE above = in[((z < nz - 1) ? z + 1 : z) * plane + column];                      \
+		if (xyBoundary || z == 0 || z == nz - 1)                                           \
+			out[idx] = center;                                                             \
+		else                                                                               \
+			out[idx] = weight * (center + in[idx - 1] + in[idx + 1] + in[idx - nx] + in[idx + nx] + below + above); \
+		below = center;                                                                    \
+		center = above;                                                                    \
+	}                                                                                      \
+}
+
+// jacobi5Naive/Local/RegBlock, jacobi9Naive/Local/RegBlock and jacobi7Naive/Local/RegBlock, Double and Float
+STENCIL_2D_KERNELS(Double, double)
+STENCIL_2D_KERNELS(Float, float)
+STENCIL_3D_KERNELS(Double, double)
+STENCIL_3D_KERNELS(Float, float)
@@ -0,0 +1,704 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Grid sizes. 2-D grids are square, 3-D grids are cubes. Sizes must be multiples of
+// TILE_X, TILE_Y * REGBLOCK, TILE3D_X, TILE3D_Y and TILE3D_Z * REGBLOCK.
+#define GRIDS2D {1024, 4096, 8192}
+#define GRIDS3D {64, 128, 256}
+
+// Work-group shapes and register blocking, passed to kernels.cl at build time
+#define TILE_X 32
+#define TILE_Y 8
+#define TILE3D_X 32
+#define TILE3D_Y 4
+#define TILE3D_Z 2
+#define REGBLOCK 8
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-launch results during test?
+// #define VERBOSE
+
+// Host reference, same order of additions as the kernels
+#define HOST_JACOBI(TYPENAME, TYPE)                                                                 \
+void HostJacobi##TYPENAME(const TYPE *in, TYPE *out, size_t nx, size_t ny, size_t nz, int points, TYPE weight) \
+{                                                                                                  \
+	size_t plane = nx * ny;                                                                        \
+	for (size_t z = 0; z < nz; z++)                                                                \
+		for (size_t y = 0; y < ny; y++)                                                            \
+			for (size_t x = 0; x < nx; x++)                                                        \
+			{                                                                                      \
+				size_t idx = z * plane + y * nx + x;                                               \
+				if (x == 0 || y == 0 || x == nx - 1 || y == ny - 1 || (nz > 1 && (z == 0 || z == nz - 1))) \
+					out[idx] = in[idx];                                                            \
+				else if (points == 5)                                                              \
+					out[idx] = weight * (in[idx] + in[idx - 1] + in[idx + 1] + in[idx - nx] + in[idx + nx]); \
+				else if (points == 9)                                                              \
+					out[idx] = weight * (in[idx - nx - 1] + in[idx - nx] + in[idx - nx + 1] +     \
+										 in[idx - 1] + in[idx] + in[idx + 1] +                     \
+										 in[idx + nx - 1] + in[idx + nx] + in[idx + nx + 1]);      \
+				else                                                                               \
+					out[idx] = weight * (in[idx] + in[idx - 1] + in[idx + 1] + in[idx - nx] + in[idx + nx] + \
+										 in[idx - plane] + in[idx + plane]);                       \
+			}                                                                                      \
+}
+
+// Function prototypes
+double GetWallTime(void);
+void HostJacobiDouble(const double *in, double *out, size_t nx, size_t ny, size_t nz, int points, double weight);
+void HostJacobiFloat(const float *in, float *out, size_t nx, size_t ny, size_t nz, int points, float weight);
+void RunStencilTests(cl_context *context, cl_command_queue *queue, cl_program *program, int points, size_t n, int dims);
+void RunStencilTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, int dims, const size_t *globalSize, const size_t *localSize,
+					size_t gridPoints, int flopsPerPoint, size_t dataType, cl_mem *out, const void *reference);
+int CompareResults(const void *result, const void *reference, size_t n, size_t dataType);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(int argc, char *argv[])
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	const size_t grids2D[] = GRIDS2D;
+	const size_t grids3D[] = GRIDS3D;
+
+	// Effective bandwidth counts one read and one write per grid point, what an ideal cache would give.
+	printf("Work-groups %dx%d (2-D) and %dx%dx%d (3-D), %d points per work-item in the RegBlock kernels\n",
+		   TILE_X, TILE_Y, TILE3D_X, TILE3D_Y, TILE3D_Z, REGBLOCK);
+	printf("-------------------------------------------------------------------------------------------------------\n");
+	printf("Function                      Grid   Effective GB/s   Avg time   Min time   Max time   Best GFLOPS\n");
+	printf("-------------------------------------------------------------------------------------------------------\n");
+	for (int g = 0; g < (int)(sizeof(grids2D) / sizeof(grids2D[0])); g++)
+	{
+		if (grids2D[g] * grids2D[g] * sizeof(double) > maxAlloc)
+			continue;
+		RunStencilTests(&context, &queue, &program, 5, grids2D[g], 2);
+		RunStencilTests(&context, &queue, &program, 9, grids2D[g], 2);
+	}
+	for (int g = 0; g < (int)(sizeof(grids3D) / sizeof(grids3D[0])); g++)
+	{
+		if (grids3D[g] * grids3D[g] * grids3D[g] * sizeof(double) > maxAlloc)
+			continue;
+		RunStencilTests(&context, &queue, &program, 7, grids3D[g], 3);
+	}
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+HOST_JACOBI(Double, double)
+HOST_JACOBI(Float, float)
+
+// Runs the Naive, Local and RegBlock kernels of one stencil on an n^dims grid, for Doubles and Floats,
+// checking them against the host reference
+void RunStencilTests(cl_context *context, cl_command_queue *queue, cl_program *program, int points, size_t n, int dims)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const char *typeLetters[] = {"D", "F"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const char *variants[] = {"Naive", "Local", "RegBlock"};
+	size_t gridPoints = (dims == 2) ? n * n : n * n * n;
+	char kernelName[64];
+	char testName[64];
+	cl_kernel kernel;
+	cl_mem in, out;
+	cl_int err;
+
+	for (int p = 0; p < 2; p++)
+	{
+		size_t sizeBytes = gridPoints * typeSizes[p];
+		void *hostIn = malloc(sizeBytes);
+		void *reference = malloc(sizeBytes);
+
+		// out = weight * (sum of the points), with weight = 1 / points
+		cl_double weightD = 1.0 / points;
+		cl_float weightF = 1.0f / points;
+
+		srand(0);
+		for (size_t i = 0; i < gridPoints; i++)
+		{
+			if (p == 0)
+				((double *)hostIn)[i] = (double)rand() / RAND_MAX;
+			else
+				((float *)hostIn)[i] = (float)rand() / RAND_MAX;
+		}
+		if (p == 0)
+			HostJacobiDouble(hostIn, reference, n, n, (dims == 2) ? 1 : n, points, weightD);
+		else
+			HostJacobiFloat(hostIn, reference, n, n, (dims == 2) ? 1 : n, points, weightF);
+
+		in = clCreateBuffer(*context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeBytes, hostIn, &err);
+		out = clCreateBuffer(*context, CL_MEM_READ_WRITE, sizeBytes, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+
+		for (int v = 0; v < 3; v++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "jacobi%d%s%s", points, variants[v], precisions[p]);
+			snprintf(testName, sizeof(testName), "jacobi%d%s%s", points, variants[v], typeLetters[p]);
+			kernel = clCreateKernel(*program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+
+			cl_uint size = n;
+			int arg = 0;
+			err = clSetKernelArg(kernel, arg++, sizeof(cl_mem), &in);
+			err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &out);
+			for (int d = 0; d < dims; d++)
+				err |= clSetKernelArg(kernel, arg++, sizeof(cl_uint), &size);
+			if (p == 0)
+				err |= clSetKernelArg(kernel, arg++, sizeof(cl_double), &weightD);
+			else
+				err |= clSetKernelArg(kernel, arg++, sizeof(cl_float), &weightF);
+			CheckOpenCLError(err, __LINE__);
+
+			// RegBlock kernels do REGBLOCK points along the last dimension per work-item
+			size_t globalSize[3] = {n, n, n};
+			size_t localSize[3] = {TILE3D_X, TILE3D_Y, TILE3D_Z};
+			if (dims == 2)
+			{
+				localSize[0] = TILE_X;
+				localSize[1] = TILE_Y;
+			}
+			if (v == 2)
+				globalSize[dims - 1] /= REGBLOCK;
+
+			// Flops per point: the additions plus the multiplication by the weight
+			RunStencilTest(queue, &kernel, testName, dims, globalSize, localSize, gridPoints, points, typeSizes[p], &out, reference);
+			clReleaseKernel(kernel);
+		}
+		printf("-------------------------------------------------------------------------------------------------------\n");
+
+		clReleaseMemObject(in);
+		clReleaseMemObject(out);
+		free(hostIn);
+		free(reference);
+	}
+}
+
+// Times NTIMES launches one by one. The output of the first one is checked against the reference.
+void RunStencilTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, int dims, const size_t *globalSize, const size_t *localSize,
+					size_t gridPoints, int flopsPerPoint, size_t dataType, cl_mem *out, const void *reference)
+{
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	cl_int err;
+
+	const cl_uint zero = 0;
+	err = clEnqueueFillBuffer(*queue, *out, &zero, sizeof(zero), 0, gridPoints * dataType, 0, NULL, NULL);
+	err |= clEnqueueNDRangeKernel(*queue, *kernel, dims, NULL, globalSize, localSize, 0, NULL, NULL);
+	CheckOpenCLError(err, __LINE__);
+
+	void *result = malloc(gridPoints * dataType);
+	clEnqueueReadBuffer(*queue, *out, CL_TRUE, 0, gridPoints * dataType, result, 0, NULL, NULL);
+	if (!CompareResults(result, reference, gridPoints, dataType))
+		printf("Error in %s, results differ from the host reference!\n", testName);
+	free(result);
+
+	for (int n = 0; n < NTIMES; n++)
+	{
+		double time = GetWallTime();
+		err = clEnqueueNDRangeKernel(*queue, *kernel, dims, NULL, globalSize, localSize, 0, NULL, NULL);
+		clFinish(*queue);
+		time = GetWallTime() - time;
+		CheckOpenCLError(err, __LINE__);
+
+		if (time < bestTime)
+		{
+			bestTime = time;
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+
+#ifdef VERBOSE
+		printf("------------- launch %2d, bandwidth = %7.3lf GB/s\n", n, 2 * gridPoints * dataType / 1024.0 / 1024.0 / 1024.0 / time);
+#endif
+	}
+
+	char grid[32];
+	if (dims == 2)
+		snprintf(grid, sizeof(grid), "%zu^2", globalSize[0]);
+	else
+		snprintf(grid, sizeof(grid), "%zu^3", globalSize[0]);
+
+	printf("%-22s   %9s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %11.3lf\n",
+		   testName, grid, 2 * gridPoints * dataType / 1024.0 / 1024.0 / 1024.0 / bestTime, totalTime / NTIMES,
+		   bestTime, worstTime, flopsPerPoint * gridPoints / 1.0e9 / bestTime);
+}
+
+// Returns 1 if every point is within a relative error of the reference, 1e-12 for doubles and 1e-5 for floats
+int CompareResults(const void *result, const void *reference, size_t n, size_t dataType)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		double r = (dataType == sizeof(double)) ? ((const double *)result)[i] : ((const float *)result)[i];
+		double ref = (dataType == sizeof(double)) ? ((const double *)reference)[i] : ((const float *)reference)[i];
+		double epsilon = (dataType == sizeof(double)) ? 1e-12 : 1e-5;
+		double scale = (fabs(ref) > 1.0) ? fabs(ref) : 1.0;
+
+		if (fabs(r - ref) > epsilon * scale)
+		{
+#ifdef VERBOSE
+			printf("Point %zu is %e, expected %e\n", i, r, ref);
+#endif
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program, the host sets the work-group shapes and register blocking
+	char buildOptions[256];
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -DTILE_X=%d -DTILE_Y=%d -DTILE3D_X=%d -DTILE3D_Y=%d -DTILE3D_Z=%d -DREGBLOCK=%d",
+			 TILE_X, TILE_Y, TILE3D_X, TILE3D_Y, TILE3D_Z, REGBLOCK);
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>        // clock_gettime()
 #include <float.h>       // DBL_MIN
+#include <math.h>        // fabs()
+#include <string.h>      // strstr()
 
 /* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
 #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
@@ -18,15 +20,56 @@
 // Print per-local-size results during test?
 //#define VERBOSE
 
+// Print the kernel resources (registers, spills, private and local memory, max work-group size)
+// and the estimated occupancy for every local size next to the results?
+#define RESOURCEREPORT
+
+// AMD MI100 Specs, used for the occupancy estimate: wavefront slots and SIMDs per CU
+#define WFP 40
+#define SIMD 4
+
+// Kernel resources the compiler writes to the build log, when the vendor gives them
+#define MAXKERNELS 256
+typedef struct {
+	char name[64];
+	int registers;    // VGPRs on AMD, registers per thread on NVIDIA, -1 if unknown
+	int spills;       // spilled VGPRs on AMD, spill store bytes on NVIDIA, -1 if unknown
+	int wavesPerSIMD; // occupancy limit given by the AMD compiler, -1 if unknown
+} KernelResources;
+
+KernelResources kernelResources[MAXKERNELS];
+int numKernelResources = 0;
+
+// Also run the kernels interleaved like the reference STREAM benchmark: every iteration
+// runs copy, scale, add and triad back to back, each kernel timed with profiling events.
+#define INTERLEAVED
+
+// Local size used by the interleaved runs
+#define INTERLEAVEDLOCALSIZE 128
+
+// The interleaved runs are repeated with arrays of at least LLCFACTOR times the size of
+// the last-level cache (CL_DEVICE_GLOBAL_MEM_CACHE_SIZE), the reference STREAM rule.
+#define LLCFACTOR 4
+
 // Function prototypes
 double GetWallTime(void);
 void RunTest(cl_command_queue * queue, cl_kernel * kernel, size_t vecWidth, char * testName, int memops, int flops, size_t arraySize);
 void VerifyResults(cl_command_queue * queue, cl_mem * device_A, float scalar, size_t arraySize);
+void RunInterleavedTests(cl_command_queue * queue, cl_kernel * initialiseArraysKernel, cl_kernel * copyKernels, cl_kernel * scaleKernels,
+                         cl_kernel * addKernels, cl_kernel * triadKernels, cl_mem * device_A, cl_mem * device_B, cl_mem * device_C,
+                         float scalar, size_t arraySize);
+void RunInterleavedTest(cl_command_queue * queue, cl_kernel * kernels, size_t vecWidth, size_t arraySize);
+void VerifyInterleavedResults(cl_command_queue * queue, cl_mem * device_A, cl_mem * device_B, cl_mem * device_C, float scalar, size_t arraySize);
 
 // OpenCL Stuff
 int InitialiseCLEnvironment(cl_platform_id**, cl_device_id***, cl_context*, cl_command_queue*, cl_program*, cl_ulong*, cl_ulong*);
 void CleanUpCLEnvironment(cl_platform_id**, cl_device_id***, cl_context*, cl_command_queue*, cl_program*);
 void CheckOpenCLError(cl_int err, int line);
+const char * ResourceUsageBuildOptions(cl_device_id device);
+KernelResources * AddKernelResources(const char * name);
+void ParseBuildLog(cl_program program, cl_device_id device);
+double EstimateOccupancy(size_t localSize, size_t maxWorkGroupSize, size_t wavefrontSize, cl_ulong kernelLocalMem, cl_ulong deviceLocalMem, int wavesPerSIMD);
+void PrintKernelResources(cl_command_queue * queue, cl_kernel * kernel);
 
 const char * const kernelFileName = "kernels.cl";
 
@@ -186,7 +229,11 @@ int main(void) {
 	// Fourth argument is the number of memory operations per output array item. Used in bandwidth calculation.
 	// Fifth argument is the number of flops per output array item. Used in flops calculation.
 	printf("---------------------------------------------------------------------------------------------------\n");
-	printf("Function        Best Rate GB/s   Avg time   Min time   Max time   Best Workgroup Size   Best GFLOPS\n");
+	printf("Function        Best Rate GB/s   Avg time   Min time   Max time   Best Workgroup Size   Best GFLOPS");
+#ifdef RESOURCEREPORT
+	printf("   Regs   Spills   Private   Local   MaxWG   Occupancy %% (16/32/64/128/256)");
+#endif
+	printf("\n");
 	printf("---------------------------------------------------------------------------------------------------\n");
 	RunTest(&queue, &copyKernel1,  1,  "copyKernel1",  2, 0, arraySize);
 	RunTest(&queue, &copyKernel2,  2,  "copyKernel2",  2, 0, arraySize);
@@ -216,6 +263,48 @@ int main(void) {
 	// Check results are correct
 	VerifyResults(&queue, &device_A, scalar, arraySize);
 
+#ifdef INTERLEAVED
+	cl_kernel copyKernels[]  = {copyKernel1,  copyKernel2,  copyKernel4,  copyKernel8,  copyKernel16};
+	cl_kernel scaleKernels[] = {scaleKernel1, scaleKernel2, scaleKernel4, scaleKernel8, scaleKernel16};
+	cl_kernel addKernels[]   = {addKernel1,   addKernel2,   addKernel4,   addKernel8,   addKernel16};
+	cl_kernel triadKernels[] = {triadKernel1, triadKernel2, triadKernel4, triadKernel8, triadKernel16};
+
+	printf("\nInterleaved copy->scale->add->triad, array size %zu\n", arraySize);
+	RunInterleavedTests(&queue, &initialiseArraysKernel, copyKernels, scaleKernels, addKernels, triadKernels,
+	                    &device_A, &device_B, &device_C, scalar, arraySize);
+
+	// Repeat with arrays that can not live in the last-level cache
+	cl_device_id device;
+	cl_ulong cacheSize;
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE, sizeof(cacheSize), &cacheSize, NULL);
+
+	// Multiple of 4096, so every vector width and local size divides it
+	size_t llcArraySize = LLCFACTOR*cacheSize/sizeof(float);
+	llcArraySize = ((llcArraySize + 4095)/4096)*4096;
+	size_t llcSizeBytes = llcArraySize*sizeof(float);
+
+	if (llcArraySize <= arraySize) {
+		printf("Array size %zu is already at least %d times the last-level cache (%luKB)\n", arraySize, LLCFACTOR, cacheSize/1024);
+	} else if (llcSizeBytes > maxAlloc || 3*llcSizeBytes > globalMemSize) {
+		printf("Can not allocate arrays of %zuMB to defeat the last-level cache, skipping\n", llcSizeBytes/1024/1024);
+	} else {
+		cl_mem device_llcA, device_llcB, device_llcC;
+		device_llcA = clCreateBuffer(context, CL_MEM_READ_WRITE, llcSizeBytes, NULL, &err);
+		device_llcB = clCreateBuffer(context, CL_MEM_READ_WRITE, llcSizeBytes, NULL, &err);
+		device_llcC = clCreateBuffer(context, CL_MEM_READ_WRITE, llcSizeBytes, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+
+		printf("\nInterleaved copy->scale->add->triad, array size %zu (%d x %luKB last-level cache)\n", llcArraySize, LLCFACTOR, cacheSize/1024);
+		RunInterleavedTests(&queue, &initialiseArraysKernel, copyKernels, scaleKernels, addKernels, triadKernels,
+		                    &device_llcA, &device_llcB, &device_llcC, scalar, llcArraySize);
+
+		clReleaseMemObject(device_llcA);
+		clReleaseMemObject(device_llcB);
+		clReleaseMemObject(device_llcC);
+	}
+#endif
+
 	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
 	return 0;
 }
@@ -261,9 +350,14 @@ void RunTest(cl_command_queue * queue, cl_kernel * kernel, size_t vecWidth, char
 
 	}
 
-	printf("%13s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %19zu   %11.3lf\n",
+	printf("%13s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %19zu   %11.3lf",
 	       testName, memops*NTIMES*arraySize*sizeof(float)/1024.0/1024.0/1024.0/bestTime, totalTime/NTIMES,
 	       bestTime, worstTime, bestLocalSize, flops*NTIMES*arraySize/1.0e9/bestTime);
+#ifdef RESOURCEREPORT
+	PrintKernelResources(queue, kernel);
+#else
+	printf("\n");
+#endif
 }
 
 
@@ -301,6 +395,144 @@ void VerifyResults(cl_command_queue *queue, cl_mem *device_A, float scalar, size
 
 
 
+void RunInterleavedTests(cl_command_queue * queue, cl_kernel * initialiseArraysKernel, cl_kernel * copyKernels, cl_kernel * scaleKernels,
+                         cl_kernel * addKernels, cl_kernel * triadKernels, cl_mem * device_A, cl_mem * device_B, cl_mem * device_C,
+                         float scalar, size_t arraySize)
+{
+	const size_t vecWidths[] = {1, 2, 4, 8, 16};
+	size_t initLocalSize = 32;
+	size_t initGlobalSize = arraySize;
+	int err;
+
+	printf("---------------------------------------------------------------------------------------------------\n");
+	printf("Function        Best Rate GB/s   Avg time   Min time   Max time   Workgroup Size\n");
+	printf("---------------------------------------------------------------------------------------------------\n");
+
+	for (int w = 0; w < 5; w++) {
+		// Same arrays and arguments as the isolated tests, the kernels are chained through them:
+		// c = a, b = scalar*c, c = a + b, a = b + scalar*c
+		err  = clSetKernelArg(*initialiseArraysKernel, 0, sizeof(cl_mem), device_A);
+		err |= clSetKernelArg(*initialiseArraysKernel, 1, sizeof(cl_mem), device_B);
+		err |= clSetKernelArg(*initialiseArraysKernel, 2, sizeof(cl_mem), device_C);
+		err |= clSetKernelArg(copyKernels[w], 0, sizeof(cl_mem), device_A);
+		err |= clSetKernelArg(copyKernels[w], 1, sizeof(cl_mem), device_C);
+		err |= clSetKernelArg(scaleKernels[w], 0, sizeof(float), &scalar);
+		err |= clSetKernelArg(scaleKernels[w], 1, sizeof(cl_mem), device_B);
+		err |= clSetKernelArg(scaleKernels[w], 2, sizeof(cl_mem), device_C);
+		err |= clSetKernelArg(addKernels[w], 0, sizeof(cl_mem), device_A);
+		err |= clSetKernelArg(addKernels[w], 1, sizeof(cl_mem), device_B);
+		err |= clSetKernelArg(addKernels[w], 2, sizeof(cl_mem), device_C);
+		err |= clSetKernelArg(triadKernels[w], 0, sizeof(float), &scalar);
+		err |= clSetKernelArg(triadKernels[w], 1, sizeof(cl_mem), device_A);
+		err |= clSetKernelArg(triadKernels[w], 2, sizeof(cl_mem), device_B);
+		err |= clSetKernelArg(triadKernels[w], 3, sizeof(cl_mem), device_C);
+		CheckOpenCLError(err, __LINE__);
+
+		// Every width starts from the initial values, so the results can be checked
+		err = clEnqueueNDRangeKernel(*queue, *initialiseArraysKernel, 1, NULL, &initGlobalSize, &initLocalSize, 0, NULL, NULL);
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		cl_kernel kernels[4] = {copyKernels[w], scaleKernels[w], addKernels[w], triadKernels[w]};
+		RunInterleavedTest(queue, kernels, vecWidths[w], arraySize);
+
+		VerifyInterleavedResults(queue, device_A, device_B, device_C, scalar, arraySize);
+		printf("---------------------------------------------------------------------------------------------------\n");
+	}
+}
+
+
+
+void RunInterleavedTest(cl_command_queue * queue, cl_kernel * kernels, size_t vecWidth, size_t arraySize)
+{
+	const char * names[4] = {"copyKernel", "scaleKernel", "addKernel", "triadKernel"};
+	const int memops[4] = {2, 2, 3, 3};
+	size_t localSize = INTERLEAVEDLOCALSIZE;
+	size_t globalSize = arraySize/vecWidth;
+	cl_event events[NTIMES][4];
+	int err = CL_SUCCESS;
+
+	// Copy, scale, add and triad back to back on every iteration, like the reference STREAM
+	for (int n = 0; n < NTIMES; n++) {
+		for (int j = 0; j < 4; j++) {
+			err |= clEnqueueNDRangeKernel(*queue, kernels[j], 1, NULL, &globalSize, &localSize, 0, NULL, &events[n][j]);
+		}
+	}
+	clFinish(*queue);
+	CheckOpenCLError(err, __LINE__);
+
+	for (int j = 0; j < 4; j++) {
+		double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+
+		for (int n = 0; n < NTIMES; n++) {
+			cl_ulong start, end;
+			clGetEventProfilingInfo(events[n][j], CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+			clGetEventProfilingInfo(events[n][j], CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+			clReleaseEvent(events[n][j]);
+
+			// The reference STREAM skips the first iteration
+			if (n == 0) continue;
+
+			double time = (end - start)*1.0e-9;
+			if (time < bestTime) bestTime = time;
+			if (time > worstTime) worstTime = time;
+			totalTime += time;
+		}
+
+		char testName[32];
+		snprintf(testName, sizeof(testName), "%s%zu", names[j], vecWidth);
+		printf("%13s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %14zu\n",
+		       testName, memops[j]*arraySize*sizeof(float)/1024.0/1024.0/1024.0/bestTime, totalTime/(NTIMES-1),
+		       bestTime, worstTime, localSize);
+	}
+}
+
+
+
+void VerifyInterleavedResults(cl_command_queue *queue, cl_mem *device_A, cl_mem *device_B, cl_mem *device_C, float scalar, size_t arraySize)
+{
+	size_t sizeBytes = arraySize * sizeof(float);
+	float *checkA = malloc(sizeBytes);
+	float *checkB = malloc(sizeBytes);
+	float *checkC = malloc(sizeBytes);
+	clEnqueueReadBuffer(*queue, *device_A, CL_TRUE, 0, sizeBytes, checkA, 0, NULL, NULL);
+	clEnqueueReadBuffer(*queue, *device_B, CL_TRUE, 0, sizeBytes, checkB, 0, NULL, NULL);
+	clEnqueueReadBuffer(*queue, *device_C, CL_TRUE, 0, sizeBytes, checkC, 0, NULL, NULL);
+
+	// Same check as checkSTREAMresults() in the reference benchmark: replay the NTIMES
+	// interleaved iterations on scalars and compare the average relative error.
+	float a = 1.0f;
+	float b = 2.0f;
+	float c = 0.0f;
+	for (int n = 0; n < NTIMES; n++) {
+		c = a;
+		b = scalar*c;
+		c = a + b;
+		a = b + scalar*c;
+	}
+
+	double errA = 0.0, errB = 0.0, errC = 0.0;
+	for (size_t i = 0; i < arraySize; i++) {
+		errA += fabs(checkA[i] - a);
+		errB += fabs(checkB[i] - b);
+		errC += fabs(checkC[i] - c);
+	}
+	errA /= arraySize;
+	errB /= arraySize;
+	errC /= arraySize;
+
+	const double epsilon = 1.0e-6;
+	if (errA/fabs(a) > epsilon || errB/fabs(b) > epsilon || errC/fabs(c) > epsilon) {
+		printf("Error in interleaved result! Average relative errors: a %e, b %e, c %e\n", errA/fabs(a), errB/fabs(b), errC/fabs(c));
+	}
+
+	free(checkA);
+	free(checkB);
+	free(checkC);
+}
+
+
+
 // Return ns accurate walltime
 double GetWallTime(void)
 {
@@ -407,7 +639,12 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
 	CheckOpenCLError(err, __LINE__);
 	//create a queue
-	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	// the interleaved runs time every kernel with profiling events
+	cl_command_queue_properties queueProperties = 0;
+#ifdef INTERLEAVED
+	queueProperties = CL_QUEUE_PROFILING_ENABLE;
+#endif
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], queueProperties, &err);
 	CheckOpenCLError(err, __LINE__);
 
 	//create the program with the source above
@@ -420,7 +657,13 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 
 	//build program executable
 	printf("Building CL Executable...\n");
-	err = clBuildProgram(*program, 0, NULL, "-I.", NULL, NULL);
+	char buildOptions[256];
+	snprintf(buildOptions, sizeof(buildOptions), "-I.%s", ResourceUsageBuildOptions((*device_id)[chosenPlatform][chosenDevice]));
+	err = clBuildProgram(*program, 0, NULL, buildOptions, NULL, NULL);
+	// Some drivers reject the resource usage options, try again without them
+	if (err != CL_SUCCESS && strcmp(buildOptions, "-I.") != 0) {
+		err = clBuildProgram(*program, 0, NULL, "-I.", NULL, NULL);
+	}
 	if (err != CL_SUCCESS) {
 		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
 		char buffer[5000];
@@ -439,6 +682,10 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 //	fclose(fp);
 //	free(bin);
 
+#ifdef RESOURCEREPORT
+	ParseBuildLog(*program, (*device_id)[chosenPlatform][chosenDevice]);
+#endif
+
 	free(numDevices);
 	free(kernelSource);
 	return EXIT_SUCCESS;
@@ -446,6 +693,153 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 
 
 
+// Vendor build options that make the compiler write register usage to the build log
+const char *ResourceUsageBuildOptions(cl_device_id device)
+{
+#ifdef RESOURCEREPORT
+	char vendor[256];
+	clGetDeviceInfo(device, CL_DEVICE_VENDOR, sizeof(vendor), vendor, NULL);
+	if (strstr(vendor, "Advanced Micro Devices") != NULL || strstr(vendor, "AMD") != NULL)
+		return " -Rpass-analysis=kernel-resource-usage";
+	if (strstr(vendor, "NVIDIA") != NULL)
+		return " -cl-nv-verbose";
+#endif
+	return "";
+}
+
+
+
+// Returns the resources entry of the kernel, adding it if it's not there yet.
+// The name ends at the first space, quote or bracket, as it comes from the build log.
+KernelResources *AddKernelResources(const char *name)
+{
+	char kernelName[64];
+	int length = 0;
+	while (name[length] != '\0' && name[length] != ' ' && name[length] != '\'' && name[length] != '[' && length < 63) {
+		kernelName[length] = name[length];
+		length++;
+	}
+	kernelName[length] = '\0';
+
+	for (int i = 0; i < numKernelResources; i++)
+		if (strcmp(kernelResources[i].name, kernelName) == 0)
+			return &kernelResources[i];
+
+	if (numKernelResources == MAXKERNELS)
+		return NULL;
+
+	KernelResources *resources = &kernelResources[numKernelResources++];
+	snprintf(resources->name, sizeof(resources->name), "%s", kernelName);
+	resources->registers = -1;
+	resources->spills = -1;
+	resources->wavesPerSIMD = -1;
+	return resources;
+}
+
+
+
+// Reads registers, spills and occupancy from the build log. AMD prints them as remarks:
+//   remark: kernels.cl:1:0: Function Name: copyKernelDouble [-Rpass-analysis=kernel-resource-usage]
+//   remark: kernels.cl:1:0:     VGPRs: 4 [...]  /  VGPRs Spill: 0 [...]  /  Occupancy [waves/SIMD]: 10 [...]
+// NVIDIA prints the ptxas info:
+//   ptxas info    : Function properties for copyKernelDouble
+//       0 bytes stack frame, 0 bytes spill stores, 0 bytes spill loads
+//   ptxas info    : Used 8 registers, 368 bytes cmem[0]
+void ParseBuildLog(cl_program program, cl_device_id device)
+{
+	size_t logSize;
+	KernelResources *current = NULL;
+	char *field;
+
+	clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &logSize);
+	char *buildLog = malloc(logSize + 1);
+	clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, logSize, buildLog, NULL);
+	buildLog[logSize] = '\0';
+
+	for (char *line = strtok(buildLog, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+		if ((field = strstr(line, "Function Name: ")) != NULL)
+			current = AddKernelResources(field + strlen("Function Name: "));
+		else if ((field = strstr(line, "Function properties for ")) != NULL)
+			current = AddKernelResources(field + strlen("Function properties for "));
+		else if (current == NULL)
+			continue;
+		else if ((field = strstr(line, "VGPRs: ")) != NULL)
+			current->registers = atoi(field + strlen("VGPRs: "));
+		else if ((field = strstr(line, "VGPRs Spill: ")) != NULL)
+			current->spills = atoi(field + strlen("VGPRs Spill: "));
+		else if ((field = strstr(line, "Occupancy [waves/SIMD]: ")) != NULL)
+			current->wavesPerSIMD = atoi(field + strlen("Occupancy [waves/SIMD]: "));
+		else if ((field = strstr(line, "bytes spill stores")) != NULL)
+			sscanf(line, " %*d bytes stack frame, %d bytes spill stores", &current->spills);
+		else if ((field = strstr(line, "Used ")) != NULL && strstr(line, "registers") != NULL)
+			current->registers = atoi(field + strlen("Used "));
+	}
+
+	free(buildLog);
+}
+
+
+
+// Estimated occupancy, as the % of the lanes of the WFP wavefront slots of a CU that are kept busy
+// by work-groups of localSize. Work-groups are limited by the wavefront slots, the local memory,
+// and the waves per SIMD the compiler allows (when known).
+double EstimateOccupancy(size_t localSize, size_t maxWorkGroupSize, size_t wavefrontSize, cl_ulong kernelLocalMem, cl_ulong deviceLocalMem, int wavesPerSIMD)
+{
+	if (localSize > maxWorkGroupSize || wavefrontSize == 0)
+		return 0.0;
+
+	size_t wavesPerGroup = (localSize + wavefrontSize - 1) / wavefrontSize;
+	size_t maxWaves = WFP;
+	if (wavesPerSIMD > 0 && (size_t)wavesPerSIMD * SIMD < maxWaves)
+		maxWaves = wavesPerSIMD * SIMD;
+
+	size_t groups = maxWaves / wavesPerGroup;
+	if (kernelLocalMem > 0 && deviceLocalMem / kernelLocalMem < groups)
+		groups = deviceLocalMem / kernelLocalMem;
+
+	return 100.0 * groups * localSize / (WFP * wavefrontSize);
+}
+
+
+
+// Prints the resources of the kernel and its occupancy for every tested local size, ending the line
+void PrintKernelResources(cl_command_queue *queue, cl_kernel *kernel)
+{
+	cl_device_id device;
+	char kernelName[64];
+	size_t maxWorkGroupSize, wavefrontSize;
+	cl_ulong privateMem, localMem, deviceLocalMem;
+	char registers[16] = "-", spills[16] = "-";
+	int wavesPerSIMD = -1;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(deviceLocalMem), &deviceLocalMem, NULL);
+	clGetKernelInfo(*kernel, CL_KERNEL_FUNCTION_NAME, sizeof(kernelName), kernelName, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(wavefrontSize), &wavefrontSize, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(privateMem), &privateMem, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof(localMem), &localMem, NULL);
+
+	for (int i = 0; i < numKernelResources; i++) {
+		if (strcmp(kernelResources[i].name, kernelName) != 0)
+			continue;
+		if (kernelResources[i].registers >= 0)
+			snprintf(registers, sizeof(registers), "%d", kernelResources[i].registers);
+		if (kernelResources[i].spills >= 0)
+			snprintf(spills, sizeof(spills), "%d", kernelResources[i].spills);
+		wavesPerSIMD = kernelResources[i].wavesPerSIMD;
+	}
+
+	printf("   %4s   %6s   %7lu   %5lu   %5zu   ", registers, spills, privateMem, localMem, maxWorkGroupSize);
+	for (size_t localSize = 16; localSize <= 256; localSize *= 2) {
+		printf("%s%3.0lf", localSize == 16 ? "" : "/",
+			   EstimateOccupancy(localSize, maxWorkGroupSize, wavefrontSize, localMem, deviceLocalMem, wavesPerSIMD));
+	}
+	printf("\n");
+}
+
+
+
 void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
 {
 	//release CL resources
@@ -197,4 +197,489 @@ __kernel void triadKernelFloat(__global float * restrict A,
 	size_t tid = get_global_id(0);
 
 	A[tid] = B[tid]+scalar * C[tid];
-}
\ No newline at end of file
+}
+
+// ---------------------------------------------------------------------------
+// Compute-bound kernels, used to find the peak FLOPS of the device.
+// Each work-item runs PEAK_CHAINS independent multiply-add chains for PEAK_ITERS
+// iterations, so the result is limited by the ALUs and not by memory.
+// PEAK_ITERS is passed by the host at build time (-DPEAK_ITERS=...).
+// ---------------------------------------------------------------------------
+#ifndef PEAK_ITERS
+#define PEAK_ITERS 128
+#endif
+
+#define MAD_STEP(r, a, b)    r = mad(r, a, b)
+#define FMA_STEP(r, a, b)    r = fma(r, a, b)
+#define MULADD_STEP(r, a, b) r = r * a + b
+
+// a is in [0.5, 0.94) so the chains converge to b/(1-a) instead of overflowing
+#define PEAK_FLOPS_KERNEL(NAME, TYPE, STYPE, STEP)                                   \
+__kernel void NAME(__global TYPE * restrict C)                                       \
+{                                                                                    \
+	size_t tid = get_global_id(0);                                                   \
+	TYPE a = (TYPE)((STYPE)0.5f + (STYPE)(get_local_id(0) & 7) * (STYPE)0.0625f);   \
+	TYPE b = (TYPE)((STYPE)0.125f);                                                  \
+	TYPE r0 = a, r1 = a + b, r2 = a - b, r3 = b;                                     \
+	TYPE r4 = a * b, r5 = a + a, r6 = b + b, r7 = a * a;                             \
+                                                                                     \
+	for (int i = 0; i < PEAK_ITERS; i++)                                             \
+	{                                                                                \
+		STEP(r0, a, b); STEP(r1, a, b); STEP(r2, a, b); STEP(r3, a, b);              \
+		STEP(r4, a, b); STEP(r5, a, b); STEP(r6, a, b); STEP(r7, a, b);              \
+	}                                                                                \
+                                                                                     \
+	C[tid] = r0 + r1 + r2 + r3 + r4 + r5 + r6 + r7;                                  \
+}
+
+#define PEAK_FLOPS_KERNELS(OP, TYPENAME, TYPE, STEP)                                  \
+	PEAK_FLOPS_KERNEL(peak##OP##TYPENAME##1,  TYPE,     TYPE, STEP)                  \
+	PEAK_FLOPS_KERNEL(peak##OP##TYPENAME##2,  TYPE##2,  TYPE, STEP)                  \
+	PEAK_FLOPS_KERNEL(peak##OP##TYPENAME##4,  TYPE##4,  TYPE, STEP)                  \
+	PEAK_FLOPS_KERNEL(peak##OP##TYPENAME##8,  TYPE##8,  TYPE, STEP)                  \
+	PEAK_FLOPS_KERNEL(peak##OP##TYPENAME##16, TYPE##16, TYPE, STEP)
+
+// Single precision: peakMadFloat1..16, peakFmaFloat1..16, peakMulAddFloat1..16
+PEAK_FLOPS_KERNELS(Mad, Float, float, MAD_STEP)
+PEAK_FLOPS_KERNELS(Fma, Float, float, FMA_STEP)
+
+// Double precision: peakMadDouble1..16, peakFmaDouble1..16, peakMulAddDouble1..16
+PEAK_FLOPS_KERNELS(Mad, Double, double, MAD_STEP)
+PEAK_FLOPS_KERNELS(Fma, Double, double, FMA_STEP)
+
+// Half precision, only built when the device supports it: peakMadHalf1..16, ...
+#ifdef cl_khr_fp16
+#pragma OPENCL EXTENSION cl_khr_fp16 : enable
+PEAK_FLOPS_KERNELS(Mad, Half, half, MAD_STEP)
+PEAK_FLOPS_KERNELS(Fma, Half, half, FMA_STEP)
+#endif
+
+// Separate multiply and add. Contraction is disabled so the compiler can not fuse
+// them back into a single fma/mad instruction.
+#pragma OPENCL FP_CONTRACT OFF
+PEAK_FLOPS_KERNELS(MulAdd, Float, float, MULADD_STEP)
+PEAK_FLOPS_KERNELS(MulAdd, Double, double, MULADD_STEP)
+#ifdef cl_khr_fp16
+PEAK_FLOPS_KERNELS(MulAdd, Half, half, MULADD_STEP)
+#endif
+#pragma OPENCL FP_CONTRACT ON
+
+// Arithmetic intensity sweep. Reads one element, runs SWEEP_FLOPS flops on it and
+// writes it back, so the flops per byte is SWEEP_FLOPS / (2 * sizeof(type)).
+// The host rebuilds this file with -DSWEEP_FLOPS=... for each point of the sweep.
+#ifndef SWEEP_FLOPS
+#define SWEEP_FLOPS 2
+#endif
+
+__kernel void intensitySweepDouble(__global const double * restrict A,
+                                   __global double * restrict C)
+{
+	size_t tid = get_global_id(0);
+	double x = A[tid];
+
+#pragma unroll
+	for (int i = 0; i < SWEEP_FLOPS / 2; i++)
+	{
+		x = fma(x, 0.75, 0.25);
+	}
+
+	C[tid] = x;
+}
+
+__kernel void intensitySweepFloat(__global const float * restrict A,
+                                  __global float * restrict C)
+{
+	size_t tid = get_global_id(0);
+	float x = A[tid];
+
+#pragma unroll
+	for (int i = 0; i < SWEEP_FLOPS / 2; i++)
+	{
+		x = fma(x, 0.75f, 0.25f);
+	}
+
+	C[tid] = x;
+}
+
+// ---------------------------------------------------------------------------
+// Fused kernels. Each one does in a single pass over memory what a sequence
+// of the kernels above does in several launches.
+// ---------------------------------------------------------------------------
+
+// Copy, Scale, Add and Triad fused with Double Precision.
+// Same result as copyKernelDouble, scaleKernelDouble, addKernelDouble and triadKernelDouble
+// in sequence, reading A once and writing A, B and C once (4 memops instead of 10).
+__kernel void fusedStreamKernelDouble(__global double * restrict A,
+                                      __global double * restrict B,
+                                      __global double * restrict C,
+                                      const double scalar)
+{
+	size_t tid = get_global_id(0);
+
+	double a = A[tid];
+	double c = a;
+	double b = scalar*c;
+	c = a + b;
+
+	A[tid] = b+scalar * c;
+	B[tid] = b;
+	C[tid] = c;
+}
+
+// Copy, Scale, Add and Triad fused with Single Precision
+__kernel void fusedStreamKernelFloat(__global float * restrict A,
+                                     __global float * restrict B,
+                                     __global float * restrict C,
+                                     const float scalar)
+{
+	size_t tid = get_global_id(0);
+
+	float a = A[tid];
+	float c = a;
+	float b = scalar*c;
+	c = a + b;
+
+	A[tid] = b+scalar * c;
+	B[tid] = b;
+	C[tid] = c;
+}
+
+// Elementwise followed by Elementwise Copy (C -> B) fused with Double Precision.
+// Reads A and B and writes C and B once (4 memops instead of 5).
+__kernel void fusedElementwiseCopyDouble(__global const double * restrict A,
+                                         __global double * restrict B,
+                                         __global double * restrict C)
+{
+  __private size_t tid = get_global_id(0);
+
+  double c = A[tid] * B[tid];
+  C[tid] = c;
+  B[tid] = c;
+}
+
+// Elementwise followed by Elementwise Copy (C -> B) fused with Single Precision
+__kernel void fusedElementwiseCopyFloat(__global const float * restrict A,
+                                        __global float * restrict B,
+                                        __global float * restrict C)
+{
+  __private size_t tid = get_global_id(0);
+
+  float c = A[tid] * B[tid];
+  C[tid] = c;
+  B[tid] = c;
+}
+
+// ---------------------------------------------------------------------------
+// Scheduling kernels. Same per-element work, distributed in different ways:
+// one element per work-item, static grid-stride, or chunks grabbed by each
+// work-group from a global atomic counter.
+// ---------------------------------------------------------------------------
+#ifndef SCHEDULE_WORK_ITERS
+#define SCHEDULE_WORK_ITERS 16
+#endif
+
+// Per element work: SCHEDULE_WORK_ITERS dependent fmas, hotFactor times more on hot elements.
+// Hot elements come in contiguous blocks of 4096, one block in 8 picked with a hash, so the
+// imbalance doesn't line up with any particular schedule. hotFactor = 1 gives uniform work.
+double scheduleWork(__global const double * restrict A, ulong i, uint hotFactor)
+{
+	uint hash = (uint)(i >> 12) * 2654435761u;
+	uint iters = SCHEDULE_WORK_ITERS * ((hash >> 29) == 0 ? hotFactor : 1);
+
+	double x = A[i];
+	for (uint k = 0; k < iters; k++)
+	{
+		x = fma(x, 0.75, 0.25);
+	}
+	return x;
+}
+
+// One element per work-item
+__kernel void scheduleItemDouble(__global const double * restrict A,
+                                 __global double * restrict C,
+                                 const uint hotFactor)
+{
+	size_t tid = get_global_id(0);
+
+	C[tid] = scheduleWork(A, tid, hotFactor);
+}
+
+// Static grid-stride, like elementwiseDoubleStride
+__kernel void scheduleStrideDouble(__global const double * restrict A,
+                                   __global double * restrict C,
+                                   ulong stride,
+                                   ulong vector_length,
+                                   const uint hotFactor)
+{
+  __private unsigned long tid = (get_local_size(0) * get_group_id(0)) + get_local_id(0);
+
+  for (; tid < vector_length; tid += stride) {
+    C[tid] = scheduleWork(A, tid, hotFactor);
+  }
+}
+
+// Dynamic: every work-group takes chunks of chunkSize elements from counters[launch] until
+// the array is done. counters must be zeroed before the launch, one counter per launch.
+__kernel void scheduleDynamicDouble(__global const double * restrict A,
+                                    __global double * restrict C,
+                                    volatile __global uint *counters,
+                                    const uint launch,
+                                    const uint chunkSize,
+                                    ulong vector_length,
+                                    const uint hotFactor)
+{
+	__local uint chunkStart;
+	size_t lid = get_local_id(0);
+
+	while (1)
+	{
+		if (lid == 0)
+			chunkStart = atomic_add(&counters[launch], chunkSize);
+		barrier(CLK_LOCAL_MEM_FENCE);
+		ulong begin = chunkStart;
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		if (begin >= vector_length)
+			break;
+
+		ulong end = begin + chunkSize < vector_length ? begin + chunkSize : vector_length;
+		for (ulong i = begin + lid; i < end; i += get_local_size(0))
+		{
+			C[i] = scheduleWork(A, i, hotFactor);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Vectorised (vloadN/vstoreN) and N-elements-per-work-item (ILP) variants of
+// Elementwise and ElementwiseCopy, with and without stride, N = 2, 4, 8, 16.
+// ---------------------------------------------------------------------------
+
+// Vec: every work-item handles one vector of N elements. For the stride variants,
+// tid, stride and vector_length count vectors, not elements.
+#define ELEMENTWISE_VEC_KERNELS(TYPENAME, TYPE, N)                                          \
+__kernel void elementwise##TYPENAME##Vec##N(__global const TYPE *A,                        \
+                                            __global const TYPE *B,                        \
+                                            __global TYPE *C)                              \
+{                                                                                          \
+  __private size_t tid = get_global_id(0);                                                 \
+                                                                                           \
+  vstore##N(vload##N(tid, A) * vload##N(tid, B), tid, C);                                  \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwise##TYPENAME##StrideVec##N(__global const TYPE *A,                  \
+                                                  __global const TYPE *B,                  \
+                                                  __global TYPE *C,                        \
+                                                  ulong stride,                            \
+                                                  ulong vector_length)                     \
+{                                                                                          \
+  __private unsigned long tid = (get_local_size(0) * get_group_id(0)) + get_local_id(0);  \
+                                                                                           \
+  for (; tid < vector_length; tid += stride) {                                             \
+    vstore##N(vload##N(tid, A) * vload##N(tid, B), tid, C);                                \
+  }                                                                                        \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwiseCopy##TYPENAME##Vec##N(__global const TYPE *A,                    \
+                                                __global TYPE *C)                          \
+{                                                                                          \
+  __private size_t tid = get_global_id(0);                                                 \
+                                                                                           \
+  vstore##N(vload##N(tid, A), tid, C);                                                     \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwiseCopy##TYPENAME##StrideVec##N(__global const TYPE *A,              \
+                                                      __global TYPE *C,                    \
+                                                      ulong stride,                        \
+                                                      ulong vector_length)                 \
+{                                                                                          \
+  __private unsigned long tid = (get_local_size(0) * get_group_id(0)) + get_local_id(0);  \
+                                                                                           \
+  for (; tid < vector_length; tid += stride) {                                             \
+    vstore##N(vload##N(tid, A), tid, C);                                                   \
+  }                                                                                        \
+}
+
+// Ilp: every work-item handles N scalar elements, one global size (or one stride) apart so
+// accesses stay coalesced. All the loads are issued before the stores.
+#define ELEMENTWISE_ILP_KERNELS(TYPENAME, TYPE, N)                                          \
+__kernel void elementwise##TYPENAME##Ilp##N(__global const TYPE *A,                        \
+                                            __global const TYPE *B,                        \
+                                            __global TYPE *C)                              \
+{                                                                                          \
+  __private size_t tid = get_global_id(0);                                                 \
+  __private size_t size = get_global_size(0);                                              \
+  __private TYPE a[N], b[N];                                                               \
+                                                                                           \
+  for (int k = 0; k < N; k++) {                                                            \
+    a[k] = A[tid + k * size];                                                              \
+    b[k] = B[tid + k * size];                                                              \
+  }                                                                                        \
+  for (int k = 0; k < N; k++) {                                                            \
+    C[tid + k * size] = a[k] * b[k];                                                       \
+  }                                                                                        \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwise##TYPENAME##StrideIlp##N(__global const TYPE *A,                  \
+                                                  __global const TYPE *B,                  \
+                                                  __global TYPE *C,                        \
+                                                  ulong stride,                            \
+                                                  ulong vector_length)                     \
+{                                                                                          \
+  __private unsigned long tid = (get_local_size(0) * get_group_id(0)) + get_local_id(0);  \
+  __private TYPE a[N], b[N];                                                               \
+                                                                                           \
+  for (; tid < vector_length; tid += stride * N) {                                         \
+    for (int k = 0; k < N; k++) {                                                          \
+      if (tid + k * stride < vector_length) {                                              \
+        a[k] = A[tid + k * stride];                                                        \
+        b[k] = B[tid + k * stride];                                                        \
+      }                                                                                    \
+    }                                                                                      \
+    for (int k = 0; k < N; k++) {                                                          \
+      if (tid + k * stride < vector_length)                                                \
+        C[tid + k * stride] = a[k] * b[k];                                                 \
+    }                                                                                      \
+  }                                                                                        \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwiseCopy##TYPENAME##Ilp##N(__global const TYPE *A,                    \
+                                                __global TYPE *C)                          \
+{                                                                                          \
+  __private size_t tid = get_global_id(0);                                                 \
+  __private size_t size = get_global_size(0);                                              \
+  __private TYPE a[N];                                                                     \
+                                                                                           \
+  for (int k = 0; k < N; k++) {                                                            \
+    a[k] = A[tid + k * size];                                                              \
+  }                                                                                        \
+  for (int k = 0; k < N; k++) {                                                            \
+    C[tid + k * size] = a[k];                                                              \
+  }                                                                                        \
+}                                                                                          \
+                                                                                           \
+__kernel void elementwiseCopy##TYPENAME##StrideIlp##N(__global const TYPE *A,              \
+                                                      __global TYPE *C,                    \
+                                                      ulong stride,                        \
+                                                      ulong vector_length)                 \
+{                                                                                          \
+  __private unsigned long tid = (get_local_size(0) * get_group_id(0)) + get_local_id(0);  \
+  __private TYPE a[N];                                                                     \
+                                                                                           \
+  for (; tid < vector_length; tid += stride * N) {                                         \
+    for (int k = 0; k < N; k++) {                                                          \
+      if (tid + k * stride < vector_length)                                                \
+        a[k] = A[tid + k * stride];                                                        \
+    }                                                                                      \
+    for (int k = 0; k < N; k++) {                                                          \
+      if (tid + k * stride < vector_length)                                                \
+        C[tid + k * stride] = a[k];                                                        \
+    }                                                                                      \
+  }                                                                                        \
+}
+
+#define ELEMENTWISE_VARIANT_KERNELS(TYPENAME, TYPE)                                         \
+  ELEMENTWISE_VEC_KERNELS(TYPENAME, TYPE, 2)                                               \
+  ELEMENTWISE_VEC_KERNELS(TYPENAME, TYPE, 4)                                               \
+  ELEMENTWISE_VEC_KERNELS(TYPENAME, TYPE, 8)                                               \
+  ELEMENTWISE_VEC_KERNELS(TYPENAME, TYPE, 16)                                              \
+  ELEMENTWISE_ILP_KERNELS(TYPENAME, TYPE, 2)                                               \
+  ELEMENTWISE_ILP_KERNELS(TYPENAME, TYPE, 4)                                               \
+  ELEMENTWISE_ILP_KERNELS(TYPENAME, TYPE, 8)                                               \
+  ELEMENTWISE_ILP_KERNELS(TYPENAME, TYPE, 16)
+
+// elementwiseDoubleVec2..16, elementwiseDoubleStrideVec2..16, elementwiseDoubleIlp2..16, ...
+ELEMENTWISE_VARIANT_KERNELS(Double, double)
+ELEMENTWISE_VARIANT_KERNELS(Float, float)
+
+// ---------------------------------------------------------------------------
+// Copy and Triad starting at an element offset, used by the alignment sweep.
+// The offset moves every access off the sub-buffer base address.
+// ---------------------------------------------------------------------------
+
+__kernel void offsetCopyKernelDouble(__global const double * restrict A,
+                                     __global double * restrict C,
+                                     const uint offset)
+{
+	size_t tid = get_global_id(0) + offset;
+
+	C[tid] = A[tid];
+}
+
+__kernel void offsetCopyKernelFloat(__global const float * restrict A,
+                                    __global float * restrict C,
+                                    const uint offset)
+{
+	size_t tid = get_global_id(0) + offset;
+
+	C[tid] = A[tid];
+}
+
+__kernel void offsetTriadKernelDouble(__global double * restrict A,
+                                      __global const double * restrict B,
+                                      __global const double * restrict C,
+                                      const double scalar,
+                                      const uint offset)
+{
+	size_t tid = get_global_id(0) + offset;
+
+	A[tid] = B[tid]+scalar * C[tid];
+}
+
+__kernel void offsetTriadKernelFloat(__global float * restrict A,
+                                     __global const float * restrict B,
+                                     __global const float * restrict C,
+                                     const float scalar,
+                                     const uint offset)
+{
+	size_t tid = get_global_id(0) + offset;
+
+	A[tid] = B[tid]+scalar * C[tid];
+}
+
+// ---------------------------------------------------------------------------
+// Index width and bounds checks: triad with 32-bit (uint) and 64-bit (ulong)
+// indices, unguarded (the launch covers exactly n items), guarded (the launch
+// is rounded up to the local size and every work-item checks tid < n, as in
+// vecAdd.c) and grid-stride (every work-item loops over the array).
+// ---------------------------------------------------------------------------
+#define INDEX_TRIAD_KERNELS(TYPENAME, TYPE, BITS, INDEX)                                     \
+__kernel void indexTriad##TYPENAME##BITS(__global TYPE * restrict A,                         \
+                                         __global const TYPE * restrict B,                   \
+                                         __global const TYPE * restrict C,                   \
+                                         const TYPE scalar,                                  \
+                                         const INDEX n)                                      \
+{                                                                                            \
+	INDEX tid = (INDEX)get_global_id(0);                                                     \
+                                                                                             \
+	A[tid] = B[tid]+scalar * C[tid];                                                         \
+}                                                                                            \
+                                                                                             \
+__kernel void indexTriad##TYPENAME##BITS##Guarded(__global TYPE * restrict A,                \
+                                                  __global const TYPE * restrict B,          \
+                                                  __global const TYPE * restrict C,          \
+                                                  const TYPE scalar,                         \
+                                                  const INDEX n)                             \
+{                                                                                            \
+	INDEX tid = (INDEX)get_global_id(0);                                                     \
+                                                                                             \
+	if (tid < n)                                                                             \
+		A[tid] = B[tid]+scalar * C[tid];                                                     \
+}                                                                                            \
+                                                                                             \
+__kernel void indexTriad##TYPENAME##BITS##Stride(__global TYPE * restrict A,                 \
+                                                 __global const TYPE * restrict B,           \
+                                                 __global const TYPE * restrict C,           \
+                                                 const TYPE scalar,                          \
+                                                 const INDEX n)                              \
+{                                                                                            \
+	INDEX stride = (INDEX)get_global_size(0);                                                \
+                                                                                             \
+	for (INDEX i = (INDEX)get_global_id(0); i < n; i += stride)                              \
+		A[i] = B[i]+scalar * C[i];                                                           \
+}
+
+INDEX_TRIAD_KERNELS(Double, double, 32, uint)
+INDEX_TRIAD_KERNELS(Double, double, 64, ulong)
+INDEX_TRIAD_KERNELS(Float, float, 32, uint)
+INDEX_TRIAD_KERNELS(Float, float, 64, ulong)
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 #include <float.h> // DBL_MIN
@@ -23,6 +24,7 @@ const char *kernelFileName = "kernels.cl";
 // AMD MI100 Specs, used for the stride benchmarks
 #define CU 120
 #define WFP 40
+#define SIMD 4
 
 // For fast executions you can auto-select the device and platform and skip the scanf
 #define AUTOPLATFORM 0
@@ -31,15 +33,340 @@ const char *kernelFileName = "kernels.cl";
 // Print per-local-size results during test?
 // #define VERBOSE
 
+// Print the kernel resources (registers, spills, private and local memory, max work-group size)
+// and the estimated occupancy for every local size next to the results?
+#define RESOURCEREPORT
+
+// Peak compute tests: every work-item runs PEAK_CHAINS independent multiply-add chains
+// PEAK_ITERS times. PEAK_ITERS is passed to kernels.cl at build time, PEAK_CHAINS must
+// match the number of chains written in PEAK_FLOPS_KERNEL.
+#define PEAK_ITERS 128
+#define PEAK_CHAINS 8
+
+// Arithmetic intensity sweep, flops per element go from 2 to MAXSWEEPFLOPS in powers of 2.
+// kernels.cl is rebuilt with -DSWEEP_FLOPS for every point.
+#define MAXSWEEPFLOPS 512
+
+// Fusion tests run from FUSIONMINSIZE elements up to the array size, in powers of 4
+#define FUSIONMINSIZE 65536
+
+// Command buffer tests (cl_khr_command_buffer): the NTIMES launches of a kernel, and of the whole copy, scale, add,
+// triad sequence, recorded once and replayed, against enqueueing every launch. From CMDBUFMINSIZE elements up to the
+// array size in powers of 4, with CMDBUFLOCALSIZE work-items per work-group. Times are the best of CMDBUFRUNS.
+#define CMDBUFMINSIZE 1024
+#define CMDBUFLOCALSIZE 64
+#define CMDBUFRUNS 5
+
+// Copy and fill commands of the runtime (clEnqueueCopyBuffer, clEnqueueCopyBufferRect, clEnqueueFillBuffer), which may
+// run on the DMA engines instead of the compute units. The 2D rectangular copy takes the left half of every row of the
+// array seen as rows of COPYRECTWIDTH elements, the 3D one the top left quarter of every slice of COPYRECTSIDE x COPYRECTSIDE.
+// In the main table they are repeated COPYAPIRUNS times, like the 5 local sizes of a kernel, and they are also compared
+// with the copy kernels from COPYMINSIZE elements up to the array size in powers of 4.
+#define COPYRECTWIDTH 1024
+#define COPYRECTSIDE 256
+#define COPYAPIRUNS 5
+#define COPYMINSIZE 65536
+
+// Index width and bounds checks: triad with 32 and 64-bit indices, unguarded (a peeled tail launch when the size isn't a
+// multiple of the local size), guarded and grid-stride, on arrays INDEXTAILS elements smaller than the array size.
+#define INDEXTAILS {0, 1, 37, 255}
+
+// Scheduling tests: hot elements get HOTFACTOR times more work in the skewed runs,
+// and the dynamic kernels are tested with every chunk size in CHUNKSIZES.
+#define HOTFACTOR 32
+#define CHUNKSIZES {256, 1024, 4096}
+
+// Alignment sweep: A, B and C are carved out of one buffer with clCreateSubBuffer, ALIGNSWEEPSIZE elements
+// each plus a gap. Gaps go from CL_DEVICE_MEM_BASE_ADDR_ALIGN to MAXALIGNGAP bytes in powers of 2, then the
+// kernels are run from element offsets up to MAXELEMENTOFFSET to test accesses below the base alignment.
+#define ALIGNSWEEPSIZE (163840 * 8 * 8)
+#define MAXALIGNGAP 65536
+#define MAXELEMENTOFFSET 32
+
+// Device memory arena: one region is allocated at start up, in blocks of at most CL_DEVICE_MAX_MEM_ALLOC_SIZE, and the
+// arrays of every test are sub-buffers of it. The Double and Float arrays are views of the same memory, so together with
+// the scratch block of the alignment sweep (which carves its own arrays out of it, away from the ones of the other tests)
+// they can take up to ARENAFRACTION of the global memory.
+#define ARENAFRACTION 0.75
+#define MAXARENABLOCKS 16
+#define MAXARENAVIEWS 16
+
+// The roofline is also written here, one line per test, to be plotted
+#define ROOFLINEFILE "roofline.csv"
+
+// Record the queued, submit, start and end times of every command timed by RunTest() and TimeKernelSequence(),
+// and the host phases (program build, buffer creation, initialisation, verification, every test), and write them
+// to TRACEFILE in the Chrome trace event format, to open in chrome://tracing or ui.perfetto.dev. Enables profiling on the queue.
+// #define TRACE
+#define TRACEFILE "trace.json"
+#define MAXTRACESPANS 65536
+
+// Idle analysis: for the best local size of every RunTest(), how much of the timed loop the device spent running kernels,
+// the gaps between the END of a launch and the START of the next and the QUEUED to START latency. Tests where the device
+// sat idle more than IDLETHRESHOLD of the timed loop are reported as launch bound. Enables profiling on the queue.
+// #define IDLEANALYSIS
+#define IDLETHRESHOLD 0.5
+
+// Time of every start up phase (platform and device queries, context, queue, program build, kernel creation, buffers)
+// up to the first kernel, printed at the end and written to STARTUPFILE. With LAZYKERNELS, when tests are selected
+// on the command line only their kernels are created, instead of all the kernels of the main table.
+// #define LAZYKERNELS
+#define STARTUPFILE "startup.csv"
+#define MAXSTARTUPPHASES 128
+
+// Commands only get an event when tracing or analysing the idle time
+#if defined(TRACE) || defined(IDLEANALYSIS)
+#define TRACE_EVENT(event) (event)
+#else
+#define TRACE_EVENT(event) NULL
+#endif
+
+// Results of every RunTest() call, used to build the roofline
+#define MAXRESULTS 256
+typedef struct
+{
+	char name[32];
+	double bandwidth; // GB/s
+	double gflops;
+	double intensity; // flops per byte
+	size_t dataType;
+} TestResult;
+
+TestResult results[MAXRESULTS];
+int numResults = 0;
+
+// Kernel resources the compiler writes to the build log, when the vendor gives them
+#define MAXKERNELS 256
+typedef struct
+{
+	char name[64];
+	int registers;    // VGPRs on AMD, registers per thread on NVIDIA, -1 if unknown
+	int spills;       // spilled VGPRs on AMD, spill store bytes on NVIDIA, -1 if unknown
+	int wavesPerSIMD; // occupancy limit given by the AMD compiler, -1 if unknown
+} KernelResources;
+
+KernelResources kernelResources[MAXKERNELS];
+int numKernelResources = 0;
+
+// Spans of the trace, in seconds of host wall time. Every command is split in the three rows after TRACE_HOST.
+enum { TRACE_HOST, TRACE_QUEUED, TRACE_SUBMITTED, TRACE_RUNNING, TRACE_ROWS };
+typedef struct
+{
+	char name[48];
+	int row;
+	double start, end;
+	size_t localSize; // 0 for host spans
+} TraceSpan;
+
+TraceSpan traceSpans[MAXTRACESPANS];
+int numTraceSpans = 0;
+double traceStart = 0.0;  // Host time at the start of main(), the origin of the trace
+double traceOffset = 0.0; // Host time of the device timestamp 0
+
+// Registry of the kernels of the main table, one line per kernel:
+//   kernel test bytesRead bytesWritten flops [role ...]
+// with the bytes read and written and the flops per array item, and optionally the role of every argument, in order:
+// in, out, inout (arrays), scalar, stride (set by RunTest(), a ulong) or length (the array size). Without roles they are
+// taken from clGetKernelArgInfo: const global pointers are in, other global pointers out, integers named stride the
+// stride, other integers the length and floating point values scalars. Arrays named A, B or C get that array, others
+// the next free one. "source file.cl" and "options ..." lines set the kernel file and extra build options, "---"
+// prints a separator after the kernel before it and # starts a comment.
+#define MAXREGISTRY 128
+#define MAXKERNELARGS 16
+enum { ROLE_IN, ROLE_OUT, ROLE_INOUT, ROLE_SCALAR, ROLE_STRIDE, ROLE_LENGTH, NUMROLES };
+typedef struct
+{
+	char kernelName[64];
+	char testName[32];
+	int bytesRead, bytesWritten, flops;
+	int numRoles; // 0 to take them from clGetKernelArgInfo
+	int roles[MAXKERNELARGS];
+	int separator;
+	cl_kernel kernel; // NULL when not created or its arguments can't be bound
+	// Set when binding the arguments
+	size_t dataType; // element size of the first array
+	int memops, strideIdx;
+} RegistryEntry;
+
+RegistryEntry registry[MAXREGISTRY];
+int numRegistry = 0;
+char registrySource[256] = ""; // kernel file given by a registry file
+char registryOptions[256] = "";
+
+// The main table, used when no registry file is given
+const char *defaultRegistry[] = {
+	"elementwiseDoubleStride       elementwiseDS       16   8   1",
+	"elementwiseFloatStride        elementwiseFS        8   4   1",
+	"---",
+	"elementwiseDouble             elementwiseD        16   8   1",
+	"elementwiseFloat              elementwiseF         8   4   1",
+	"---",
+	"elementwiseCopyDoubleStride   elementwiseCopyDS    8   8   0",
+	"elementwiseCopyFloatStride    elementwiseCopyFS    4   4   0",
+	"---",
+	"elementwiseCopyDouble         elementwiseCopyD     8   8   0",
+	"elementwiseCopyFloat          elementwiseCopyF     4   4   0",
+	"---",
+	"copyKernelDouble              copyKernelD          8   8   0",
+	"copyKernelFloat               copyKernelF          4   4   0",
+	"---",
+	"scaleKernelDouble             scaleKernelD         8   8   1",
+	"scaleKernelFloat              scaleKernelF         4   4   1",
+	"---",
+	"addKernelDouble               addKernelD          16   8   1",
+	"addKernelFloat                addKernelF           8   4   1",
+	"---",
+	"triadKernelDouble             triadKernelD        16   8   2",
+	"triadKernelFloat              triadKernelF         8   4   2",
+	"---",
+};
+
+// Tests of the main table given on the command line, all when there are none
+char **selectedTests = NULL;
+int numSelectedTests = 0;
+
+// Start up phases, recorded until startupTime is set when the first kernel is about to run
+typedef struct
+{
+	char name[48];
+	double time;
+} StartupPhase;
+
+StartupPhase startupPhases[MAXSTARTUPPHASES];
+int numStartupPhases = 0;
+double startupTime = 0.0; // From the start of main() to the first kernel
+
+// Idle analysis of every RunTest() call
+typedef struct
+{
+	char name[32];
+	double bandwidth;       // GB/s over the timed loop, as reported by RunTest()
+	double kernelBandwidth; // GB/s over the time the kernels were running
+	double busy;            // fraction of the timed loop the kernels were running
+	double meanGap, p99Gap; // END of a launch to START of the next, in seconds
+	double meanLatency;     // QUEUED to START, in seconds
+} IdleResult;
+
+IdleResult idleResults[MAXRESULTS];
+int numIdleResults = 0;
+
+// Device memory arena of numSlots slots of slotBytes (a multiple of CL_DEVICE_MEM_BASE_ADDR_ALIGN), slotsPerBlock in every
+// block. Views are sub-buffers starting on a slot, and are all released with the arena.
+typedef struct
+{
+	cl_mem blocks[MAXARENABLOCKS];
+	size_t blockBytes[MAXARENABLOCKS];
+	int numBlocks;
+	int numSlots, slotsPerBlock;
+	size_t slotBytes;
+	cl_mem views[MAXARENAVIEWS];
+	int numViews;
+	cl_mem scratch; // Block of the alignment sweep, NULL when there is none
+	size_t scratchBytes;
+	double createTime; // Wall time of the clCreateBuffer calls
+} Arena;
+
+// Index width tests, how the launch covers arrays of any size
+enum { INDEX_UNGUARDED, INDEX_GUARDED, INDEX_STRIDE, NUMINDEXHANDLINGS };
+
+// Copy and fill commands of the main table, A into C (C filled with ones for the fill)
+enum { COPYAPI_BUFFER, COPYAPI_RECT2D, COPYAPI_RECT3D, COPYAPI_FILL, NUMCOPYAPIS };
+typedef struct
+{
+	char testName[32];
+	int api;
+	size_t dataType;
+} CopyApiTest;
+
+const CopyApiTest copyApiTests[] = {
+	{"copyBufferD", COPYAPI_BUFFER, sizeof(double)},
+	{"copyBufferF", COPYAPI_BUFFER, sizeof(float)},
+	{"copyRect2DD", COPYAPI_RECT2D, sizeof(double)},
+	{"copyRect2DF", COPYAPI_RECT2D, sizeof(float)},
+	{"copyRect3DD", COPYAPI_RECT3D, sizeof(double)},
+	{"copyRect3DF", COPYAPI_RECT3D, sizeof(float)},
+	{"fillBufferD", COPYAPI_FILL, sizeof(double)},
+	{"fillBufferF", COPYAPI_FILL, sizeof(float)},
+};
+#define NUMCOPYAPITESTS (int)(sizeof(copyApiTests) / sizeof(copyApiTests[0]))
+
+#ifdef cl_khr_command_buffer
+// Entry points of cl_khr_command_buffer, loaded at run time. The type of the properties of clCommandNDRangeKernelKHR
+// changed between header versions and they are always NULL here, so they are declared as void.
+typedef struct
+{
+	cl_command_buffer_khr (*create)(cl_uint, const cl_command_queue *, const cl_command_buffer_properties_khr *, cl_int *);
+	cl_int (*ndRangeKernel)(cl_command_buffer_khr, cl_command_queue, const void *, cl_kernel, cl_uint, const size_t *, const size_t *,
+							const size_t *, cl_uint, const cl_sync_point_khr *, cl_sync_point_khr *, void *);
+	cl_int (*finalize)(cl_command_buffer_khr);
+	cl_int (*enqueue)(cl_uint, cl_command_queue *, cl_command_buffer_khr, cl_uint, const cl_event *, cl_event *);
+	cl_int (*release)(cl_command_buffer_khr);
+} CommandBufferApi;
+#endif
+
 // Function prototypes
 double GetWallTime(void);
 void RunTest(cl_command_queue *queue, cl_kernel *kernel, size_t vecWidth, char *testName, int memops, int flops, size_t arraySize, int strideBool, size_t dataType);
-void SanitizeAndRoundArraySize(size_t *sizeBytes, cl_ulong maxAlloc, cl_ulong globalMemSize, size_t typeSize, size_t *arraySize, char *arrayName);
-void initializeArays(cl_command_queue *queue, cl_kernel *initDoublesKernel, cl_kernel *initFloatsKernel, size_t *arraySize);
+size_t FitArraySize(size_t arraySize, int numArrays, size_t typeSize, size_t reservedBytes, cl_ulong maxAlloc, cl_ulong globalMemSize);
+int ArenaCreate(Arena *arena, cl_context context, cl_device_id device, int numSlots, size_t slotBytes, size_t scratchBytes);
+int ArenaViews(Arena *arena, int numViews, size_t viewBytes, cl_mem *views);
+void ArenaRelease(Arena *arena);
+void initializeArays(cl_command_queue *queue, cl_kernel *initKernel, cl_mem *buffers, size_t arraySize, size_t dataType);
+void RunElementwiseVariantTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize);
+void RunPeakFlopsTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffer, cl_mem *floatBuffer, size_t arraySize);
+void RunIntensitySweep(cl_context *context, cl_command_queue *queue, cl_mem *doubleIn, cl_mem *doubleOut, cl_mem *floatIn, cl_mem *floatOut, size_t arraySize);
+void PrintRoofline(void);
+void RunFusionTest(cl_command_queue *queue, cl_kernel *initKernel, cl_kernel *separateKernels, int numSeparate, int separateMemops,
+				   cl_kernel *fusedKernel, int fusedMemops, cl_mem *outputs, int numOutputs, char *testName, size_t arraySize, size_t dataType);
+void RunSchedulingTests(cl_program *program, cl_command_queue *queue, cl_mem *device_A, cl_mem *device_C, size_t arraySize);
+void RunAlignmentSweep(Arena *arena, cl_program *program, cl_command_queue *queue, size_t arraySize);
+double RunAlignmentTest(cl_mem *parent, cl_command_queue *queue, cl_kernel *kernel, int numArrays, size_t typeSize,
+						size_t elements, size_t gapBytes, cl_uint elementOffset, cl_uint baseAlign);
+double RunSchedulingTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, int strideIdx, int launchIdx, int persistent,
+						 cl_mem *counters, size_t arraySize, double baselineTime);
+double TimeKernelSequence(cl_command_queue *queue, cl_kernel *kernels, int numKernels, size_t globalSize, size_t localSize);
+size_t EnqueueCopyApi(cl_command_queue *queue, int api, cl_mem *src, cl_mem *dst, size_t size, size_t dataType, cl_event *event);
+void RunCopyApiTest(cl_command_queue *queue, int api, char *testName, cl_mem *src, cl_mem *dst, size_t arraySize, size_t dataType);
+double TimeCopyApi(cl_command_queue *queue, int api, cl_mem *src, cl_mem *dst, size_t size, size_t dataType);
+void RunCopyApiSweep(cl_command_queue *queue, cl_mem *device_A, cl_mem *device_C, size_t arraySize);
+void RunCopyOverlapTest(cl_program *program, cl_command_queue *queue, cl_mem *device_A, cl_mem *device_B, cl_mem *device_C, size_t arraySize);
+void RunIndexTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize);
+double RunIndexTest(cl_command_queue *queue, cl_kernel *kernel, int handling, size_t size, size_t *bestLocalSize);
+void RunCommandBufferTests(cl_command_queue *queue, cl_kernel *streamKernels, size_t arraySize);
+#ifdef cl_khr_command_buffer
+void RunCommandBufferTest(CommandBufferApi *api, cl_command_queue *queue, cl_kernel *kernels, int numKernels, char *testName, size_t size);
+#endif
+int CompareDeviceBuffers(cl_command_queue *queue, cl_mem *expected, cl_mem *actual, size_t sizeBytes);
+void TraceHostSpan(const char *name, double start, double end);
+void TraceAddSpan(const char *name, int row, double start, double end, size_t localSize);
+void TraceCalibrate(cl_command_queue *queue);
+void ReadCommandTimes(cl_event event, cl_ulong *times);
+void TraceCommand(const cl_ulong *times, const char *name, size_t localSize);
+void WriteTrace(void);
+void AnalyseIdleTime(const char *testName, cl_ulong (*times)[4], double time, double bytes);
+void PrintIdleAnalysis(void);
+int CompareDoubles(const void *a, const void *b);
+int TestSelected(const char *testName);
+cl_kernel MainKernel(const char *testName);
+int ParseRegistryLine(const char *text);
+int LoadRegistry(const char *fileName);
+int BindRegistryKernel(RegistryEntry *entry, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize);
+size_t ArgTypeSize(const char *typeName);
+cl_kernel CreateKernel(cl_program program, const char *kernelName);
+void AddStartupPhase(const char *name, double start, double end);
+void PrintStartupProfile(void);
+void PrintReports(void);
 
 // OpenCL Stuff
 int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
 void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+int DeviceSupportsExtension(cl_command_queue *queue, const char *extension);
+const char *ResourceUsageBuildOptions(cl_device_id device);
+KernelResources *AddKernelResources(const char *name);
+void ParseBuildLog(cl_program program, cl_device_id device);
+double EstimateOccupancy(size_t localSize, size_t maxWorkGroupSize, size_t wavefrontSize, cl_ulong kernelLocalMem, cl_ulong deviceLocalMem, int wavesPerSIMD);
+void PrintKernelResources(cl_command_queue *queue, cl_kernel *kernel);
 void CheckOpenCLError(cl_int err, int line);
 
 int main(int argc, char *argv[])
@@ -55,28 +382,64 @@ int main(int argc, char *argv[])
 	cl_ulong          maxAlloc, globalMemSize;
 	cl_program        program;
 	cl_kernel         initDoubleArrays, initFloatArrays;
-	cl_kernel         elementwiseDS, elementwiseFS;
-	cl_kernel         elementwiseD, elementwiseF;
-	cl_kernel         elementwiseCopyDS, elementwiseCopyFS;
-	cl_kernel         elementwiseCopyD, elementwiseCopyF;
-	cl_kernel         copyKernelD, copyKernelF;
-	cl_kernel         scaleKernelD, scaleKernelF;
-	cl_kernel         addKernelD, addKernelF;
-	cl_kernel         triadKernelD, triadKernelF;
 	cl_int            err;
 	cl_mem            device_dA, device_dB, device_dC;
 	cl_mem            device_fA, device_fB, device_fC;
 
+	// A registry file given with -r replaces the main table and skips everything else
+	traceStart = GetWallTime();
+	int registryFile = argc >= 3 && strcmp(argv[1], "-r") == 0;
+	if (registryFile)
+	{
+		double spanStart = GetWallTime();
+		if (!LoadRegistry(argv[2]))
+			return EXIT_FAILURE;
+		if (registrySource[0] != '\0')
+			kernelFileName = registrySource;
+		AddStartupPhase("LoadRegistry", spanStart, GetWallTime());
+	}
+	else
+	{
+		for (size_t i = 0; i < sizeof(defaultRegistry) / sizeof(defaultRegistry[0]); i++)
+			ParseRegistryLine(defaultRegistry[i]);
+	}
+
 	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
 	{
 		printf("Error initialising OpenCL environment\n");
 		return EXIT_FAILURE;
 	}
+#ifdef TRACE
+	TraceCalibrate(&queue);
+#endif
 
-	// Create kernels.
-	initDoubleArrays = clCreateKernel(program, "initialiseDoubleArraysKernel", &err);
-	initFloatArrays = clCreateKernel(program, "initialiseFloatArraysKernel", &err);
-	CheckOpenCLError(err, __LINE__);
+	// If the user inputs a size, it will be used. Otherwise, the default size is used.
+	// Test names after the size select the tests of the main table to run, skipping everything else.
+	int sizeArg = registryFile ? 3 : 1;
+	size_t arraySize = TRYARRAYSIZE;
+	if (argc > sizeArg && atoi(argv[sizeArg]) > 256 && atoi(argv[sizeArg]) % 16 == 0)
+	{
+		arraySize = (size_t)atoi(argv[sizeArg]);
+#ifdef VERBOSE
+		printf("Using array size of %zu\n", arraySize);
+#endif
+	}
+	selectedTests = argv + sizeArg + 1;
+	numSelectedTests = argc > sizeArg + 1 ? argc - sizeArg - 1 : 0;
+	for (int i = 0; i < numSelectedTests; i++)
+	{
+		int t = 0, c = 0;
+		while (t < numRegistry && strcmp(registry[t].testName, selectedTests[i]) != 0)
+			t++;
+		while (c < NUMCOPYAPITESTS && strcmp(copyApiTests[c].testName, selectedTests[i]) != 0)
+			c++;
+		if (t == numRegistry && c == NUMCOPYAPITESTS)
+			printf("Unknown test %s, tests are named as in the Function column of the main table\n", selectedTests[i]);
+	}
+
+	// Create kernels. The init kernels are in kernels.cl, a registry source file gets its arrays filled instead.
+	initDoubleArrays = registrySource[0] == '\0' ? CreateKernel(program, "initialiseDoubleArraysKernel") : NULL;
+	initFloatArrays = registrySource[0] == '\0' ? CreateKernel(program, "initialiseFloatArraysKernel") : NULL;
 
 	// There are 2 main kernels; elementwise and elementwiseCopy.
 	// ├> elementwise is used to perform computation over a vector
@@ -86,265 +449,1931 @@ int main(int argc, char *argv[])
 	// └> elementwiseCopy is used to copy data from one vector to another vector
 	//      ├> 2 kernels data-dependant, elementwiseCopyDouble and elementwiseCopyFloat
 	//      └> 2 kernels are stride-dependant & data-dependant, elementwiseCopyDoubleStride and elementwiseCopyFloatStride
-
-	elementwiseDS = clCreateKernel(program, "elementwiseDoubleStride", &err);
-	elementwiseFS = clCreateKernel(program, "elementwiseFloatStride", &err);
-	CheckOpenCLError(err, __LINE__);
-	elementwiseD = clCreateKernel(program, "elementwiseDouble", &err);
-	elementwiseF = clCreateKernel(program, "elementwiseFloat", &err);
-	CheckOpenCLError(err, __LINE__);
-	elementwiseCopyDS = clCreateKernel(program, "elementwiseCopyDoubleStride", &err);
-	elementwiseCopyFS = clCreateKernel(program, "elementwiseCopyFloatStride", &err);
-	CheckOpenCLError(err, __LINE__);
-	elementwiseCopyD = clCreateKernel(program, "elementwiseCopyDouble", &err);
-	elementwiseCopyF = clCreateKernel(program, "elementwiseCopyFloat", &err);
-	CheckOpenCLError(err, __LINE__);
-
+	//
 	// For the streaming benchmark we implement the 4 different kernels using different data types
 	// ├> copykernelDouble and copyKernelFloat
 	// ├> scaleKernelDouble and scaleKernelFloat
 	// ├> addKernelDouble and addKernelFloat
 	// └> triadKernelDouble and triadKernelFloat
+	//
+	// They are all in defaultRegistry. With LAZYKERNELS only the selected ones are created.
+	for (int t = 0; t < numRegistry; t++)
+	{
+#ifdef LAZYKERNELS
+		if (!TestSelected(registry[t].testName))
+			continue;
+#endif
+		registry[t].kernel = CreateKernel(program, registry[t].kernelName);
+	}
+
+	// The arena holds 3 arrays of doubles (in case they're bigger than the GPU memory, the size is reduced to fit),
+	// the float arrays are views of the same memory. When the whole benchmark runs, it also has a scratch block for
+	// the alignment sweep, as big as its largest test, so the sweep doesn't overwrite the arrays of the other tests.
+	cl_device_id device;
+	cl_uint baseAlignBits;
+	Arena arena;
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(baseAlignBits), &baseAlignBits, NULL);
+	size_t sweepElements = arraySize < ALIGNSWEEPSIZE ? arraySize : ALIGNSWEEPSIZE;
+	size_t scratchBytes = 0;
+	if (numSelectedTests == 0 && !registryFile)
+	{
+		scratchBytes = 3 * ((sweepElements + MAXELEMENTOFFSET) * sizeof(double) + baseAlignBits / 8 + MAXALIGNGAP);
+		if (scratchBytes > maxAlloc)
+			scratchBytes = (size_t)maxAlloc;
+	}
+	arraySize = FitArraySize(arraySize, 3, sizeof(double), scratchBytes, maxAlloc, globalMemSize);
+
+	double spanStart = GetWallTime();
+	if (!ArenaCreate(&arena, context, device, 3, arraySize * sizeof(double), scratchBytes))
+	{
+		printf("Error creating the device memory arena\n");
+		return EXIT_FAILURE;
+	}
+	AddStartupPhase("clCreateBuffer (arena)", spanStart, GetWallTime());
+#ifdef VERBOSE
+	printf("Arena of %zuMB in %d blocks, created in %.3lf ms\n", arena.numSlots * arena.slotBytes / 1024 / 1024, arena.numBlocks, arena.createTime * 1e3);
+#endif
+
+	// Set kernel arguemnts. Scale and Triad kernels involve multiplication by a scalar:
+	const double scalarD = 3.0;
+	const float scalarF = 3.0f;
+	cl_mem doubleBuffers[3], floatBuffers[3];
+	spanStart = GetWallTime();
+	ArenaViews(&arena, 3, arraySize * sizeof(double), doubleBuffers);
+	ArenaViews(&arena, 3, arraySize * sizeof(float), floatBuffers);
+	AddStartupPhase("clCreateSubBuffer", spanStart, GetWallTime());
+	device_dA = doubleBuffers[0];
+	device_dB = doubleBuffers[1];
+	device_dC = doubleBuffers[2];
+	device_fA = floatBuffers[0];
+	device_fB = floatBuffers[1];
+	device_fC = floatBuffers[2];
+
+	// Assign variables to different kernels
+	if (initDoubleArrays != NULL)
+	{
+		// initialiseDoubleArraysKernel
+		err = clSetKernelArg(initDoubleArrays, 0, sizeof(cl_mem), &device_dA);
+		err |= clSetKernelArg(initDoubleArrays, 1, sizeof(cl_mem), &device_dB);
+		err |= clSetKernelArg(initDoubleArrays, 2, sizeof(cl_mem), &device_dC);
+
+		// initialiseFloatArraysKernel
+		err |= clSetKernelArg(initFloatArrays, 0, sizeof(cl_mem), &device_fA);
+		err |= clSetKernelArg(initFloatArrays, 1, sizeof(cl_mem), &device_fB);
+		err |= clSetKernelArg(initFloatArrays, 2, sizeof(cl_mem), &device_fC);
+
+		CheckOpenCLError(err, __LINE__);
+	}
+
+	// The registry kernels from their argument info, scalars are also 3
+	for (int t = 0; t < numRegistry; t++)
+	{
+		if (registry[t].kernel != NULL && !BindRegistryKernel(&registry[t], doubleBuffers, floatBuffers, arraySize))
+		{
+			printf("Skipping %s\n", registry[t].testName);
+			clReleaseKernel(registry[t].kernel);
+			registry[t].kernel = NULL;
+		}
+	}
+
+	// The first kernel runs next, everything up to here is start up
+	startupTime = GetWallTime() - traceStart;
+
+	// Initialize arrays
+	spanStart = GetWallTime();
+	initializeArays(&queue, &initDoubleArrays, doubleBuffers, arraySize, sizeof(double));
+	initializeArays(&queue, &initFloatArrays, floatBuffers, arraySize, sizeof(float));
+	TraceHostSpan("initializeArays", spanStart, GetWallTime());
+
+	// Fourth argument is the number of memory operations per output array item. Used in bandwidth calculation.
+	// Fifth argument is the number of flops per output array item. Used in flops calculation.
+	// Seventh argument indicates kernel strie idx, and copies the wgsize to the kernel before enqueuing.
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Function             Best Rate GB/s   Avg time   Min time   Max time   Best Workgroup Size   Best GFLOPS");
+#ifdef RESOURCEREPORT
+	printf("   Regs   Spills   Private   Local   MaxWG   Occupancy %% (16/32/64/128/256)");
+#endif
+	printf("\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	for (int t = 0; t < numRegistry; t++)
+	{
+		RegistryEntry *entry = &registry[t];
+		if (entry->kernel != NULL && TestSelected(entry->testName))
+		{
+			// The Double and Float arrays are the same memory, the ones of the test are initialised again
+			if (entry->dataType == sizeof(double))
+				initializeArays(&queue, &initDoubleArrays, doubleBuffers, arraySize, sizeof(double));
+			else
+				initializeArays(&queue, &initFloatArrays, floatBuffers, arraySize, sizeof(float));
+			RunTest(&queue, &entry->kernel, 1, entry->testName, entry->memops, entry->flops, arraySize, entry->strideIdx, entry->dataType);
+		}
+		if (entry->separator || t == numRegistry - 1)
+			printf("--------------------------------------------------------------------------------------------------------\n");
+	}
+
+	// The runtime's copy and fill commands, next to the copy kernels
+	if (!registryFile)
+	{
+		for (int c = 0; c < NUMCOPYAPITESTS; c++)
+		{
+			const CopyApiTest *test = &copyApiTests[c];
+			if (TestSelected(test->testName))
+				RunCopyApiTest(&queue, test->api, (char *)test->testName, test->dataType == sizeof(double) ? &device_dA : &device_fA,
+							   test->dataType == sizeof(double) ? &device_dC : &device_fC, arraySize, test->dataType);
+			if (c % 2 == 1)
+				printf("--------------------------------------------------------------------------------------------------------\n");
+		}
+	}
+
+	// A selection of tests or a registry file only runs those
+	if (numSelectedTests > 0 || registryFile)
+	{
+		PrintReports();
+		ArenaRelease(&arena);
+		CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+		return 0;
+	}
+
+	// vloadN/vstoreN and N-elements-per-work-item variants of elementwise and elementwiseCopy
+	RunElementwiseVariantTests(&program, &queue, doubleBuffers, floatBuffers, arraySize);
+
+	// Copy kernels against the copy and fill commands across sizes, and a copy command next to a compute kernel
+	RunCopyApiSweep(&queue, &device_dA, &device_dC, arraySize);
+	RunCopyOverlapTest(&program, &queue, &device_dA, &device_dB, &device_dC, arraySize);
+
+	// 32 against 64-bit indices, and the cost of bounds checks and tails on arrays of any size
+	RunIndexTests(&program, &queue, doubleBuffers, floatBuffers, arraySize);
+
+	// Fused against separate kernels. The copy after elementwise writes C into B, so it gets its own kernels.
+	cl_kernel ewCopyCBD = clCreateKernel(program, "elementwiseCopyDouble", &err);
+	cl_kernel ewCopyCBF = clCreateKernel(program, "elementwiseCopyFloat", &err);
+	cl_kernel fusedStreamD = clCreateKernel(program, "fusedStreamKernelDouble", &err);
+	cl_kernel fusedStreamF = clCreateKernel(program, "fusedStreamKernelFloat", &err);
+	cl_kernel fusedEwCopyD = clCreateKernel(program, "fusedElementwiseCopyDouble", &err);
+	cl_kernel fusedEwCopyF = clCreateKernel(program, "fusedElementwiseCopyFloat", &err);
+	CheckOpenCLError(err, __LINE__);
+
+	err = clSetKernelArg(ewCopyCBD, 0, sizeof(cl_mem), &device_dC);
+	err |= clSetKernelArg(ewCopyCBD, 1, sizeof(cl_mem), &device_dB);
+	err |= clSetKernelArg(ewCopyCBF, 0, sizeof(cl_mem), &device_fC);
+	err |= clSetKernelArg(ewCopyCBF, 1, sizeof(cl_mem), &device_fB);
+	err |= clSetKernelArg(fusedStreamD, 0, sizeof(cl_mem), &device_dA);
+	err |= clSetKernelArg(fusedStreamD, 1, sizeof(cl_mem), &device_dB);
+	err |= clSetKernelArg(fusedStreamD, 2, sizeof(cl_mem), &device_dC);
+	err |= clSetKernelArg(fusedStreamD, 3, sizeof(double), &scalarD);
+	err |= clSetKernelArg(fusedStreamF, 0, sizeof(cl_mem), &device_fA);
+	err |= clSetKernelArg(fusedStreamF, 1, sizeof(cl_mem), &device_fB);
+	err |= clSetKernelArg(fusedStreamF, 2, sizeof(cl_mem), &device_fC);
+	err |= clSetKernelArg(fusedStreamF, 3, sizeof(float), &scalarF);
+	err |= clSetKernelArg(fusedEwCopyD, 0, sizeof(cl_mem), &device_dA);
+	err |= clSetKernelArg(fusedEwCopyD, 1, sizeof(cl_mem), &device_dB);
+	err |= clSetKernelArg(fusedEwCopyD, 2, sizeof(cl_mem), &device_dC);
+	err |= clSetKernelArg(fusedEwCopyF, 0, sizeof(cl_mem), &device_fA);
+	err |= clSetKernelArg(fusedEwCopyF, 1, sizeof(cl_mem), &device_fB);
+	err |= clSetKernelArg(fusedEwCopyF, 2, sizeof(cl_mem), &device_fC);
+	CheckOpenCLError(err, __LINE__);
+
+	cl_kernel streamD[] = {MainKernel("copyKernelD"), MainKernel("scaleKernelD"), MainKernel("addKernelD"), MainKernel("triadKernelD")};
+	cl_kernel streamF[] = {MainKernel("copyKernelF"), MainKernel("scaleKernelF"), MainKernel("addKernelF"), MainKernel("triadKernelF")};
+	cl_kernel ewCopyD[] = {MainKernel("elementwiseD"), ewCopyCBD};
+	cl_kernel ewCopyF[] = {MainKernel("elementwiseF"), ewCopyCBF};
+	cl_mem streamOutD[] = {device_dA, device_dB, device_dC};
+	cl_mem streamOutF[] = {device_fA, device_fB, device_fC};
+	cl_mem ewCopyOutD[] = {device_dB, device_dC};
+	cl_mem ewCopyOutF[] = {device_fB, device_fC};
+
+	// Fifth and seventh arguments are the memory operations per array item of the whole separate sequence and of the fused kernel
+	printf("\nFused against separate kernels, times are for %d iterations of the whole sequence\n", NTIMES);
+	printf("--------------------------------------------------------------------------------------------------------------------------------\n");
+	printf("Function             Array size   Separate time   Fused time   Speedup   Bytes saved/iter   Launches saved/iter   Fused GB/s\n");
+	printf("--------------------------------------------------------------------------------------------------------------------------------\n");
+	RunFusionTest(&queue, &initDoubleArrays, streamD, 4, 10, &fusedStreamD, 4, streamOutD, 3, "fusedStreamD", arraySize, sizeof(double));
+	RunFusionTest(&queue, &initFloatArrays, streamF, 4, 10, &fusedStreamF, 4, streamOutF, 3, "fusedStreamF", arraySize, sizeof(float));
+	printf("--------------------------------------------------------------------------------------------------------------------------------\n");
+	RunFusionTest(&queue, &initDoubleArrays, ewCopyD, 2, 5, &fusedEwCopyD, 4, ewCopyOutD, 2, "fusedEwCopyD", arraySize, sizeof(double));
+	RunFusionTest(&queue, &initFloatArrays, ewCopyF, 2, 5, &fusedEwCopyF, 4, ewCopyOutF, 2, "fusedEwCopyF", arraySize, sizeof(float));
+	printf("--------------------------------------------------------------------------------------------------------------------------------\n");
+
+	// Launch overhead: the same launches recorded in a command buffer and replayed
+	RunCommandBufferTests(&queue, streamD, arraySize);
+
+	clReleaseKernel(ewCopyCBD);
+	clReleaseKernel(ewCopyCBF);
+	clReleaseKernel(fusedStreamD);
+	clReleaseKernel(fusedStreamF);
+	clReleaseKernel(fusedEwCopyD);
+	clReleaseKernel(fusedEwCopyF);
+
+	// Static against dynamic scheduling, with uniform and skewed work per element
+	RunSchedulingTests(&program, &queue, &device_dA, &device_dC, arraySize);
+
+	// Bandwidth against the base address and element offset of the arrays
+	RunAlignmentSweep(&arena, &program, &queue, arraySize);
+
+	// Compute bound tests, to find the top of the roofline
+	RunPeakFlopsTests(&program, &queue, &device_dC, &device_fC, arraySize);
+	RunIntensitySweep(&context, &queue, &device_dA, &device_dC, &device_fA, &device_fC, arraySize);
+
+	PrintReports();
+
+	ArenaRelease(&arena);
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+void RunTest(cl_command_queue *queue, cl_kernel *kernel, size_t vecWidth, char *testName, int memops, int flops, size_t arraySize, int KernelStrideIdx, size_t dataType)
+{
+	size_t localSize;
+	size_t bestLocalSize;
+	size_t globalSize = arraySize / vecWidth;
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	double testStart = GetWallTime();
+#if defined(TRACE) || defined(IDLEANALYSIS)
+	cl_event events[NTIMES];
+	cl_ulong times[NTIMES][4], bestTimes[NTIMES][4];
+#endif
+	int err;
+
+	// Test local sizes from 2 to to 256, in powers of 2
+	for (localSize = 16; localSize <= 256; localSize *= 2)
+	{
+
+		if (KernelStrideIdx != -1)
+		{
+			globalSize = CU * WFP * localSize;
+			err = clSetKernelArg(*kernel, KernelStrideIdx, sizeof(unsigned long), &globalSize);
+		}
+
+		if (globalSize % localSize != 0)
+		{
+			printf("Error, localSize must divide globalSize! (%zu %% %zu = %zu)\n",
+			globalSize, localSize, globalSize % localSize);
+		}
+
+		double time = GetWallTime();
+
+		for (int n = 0; n < NTIMES; n++)
+		{
+			err = clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, TRACE_EVENT(&events[n]));
+		}
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		time = GetWallTime() - time;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+		for (int n = 0; n < NTIMES; n++)
+		{
+			ReadCommandTimes(events[n], times[n]);
+			TraceCommand(times[n], testName, localSize);
+		}
+#endif
+		if (time < bestTime)
+		{
+			bestTime = time;
+			bestLocalSize = localSize;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+			memcpy(bestTimes, times, sizeof(times));
+#endif
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+
+#ifdef VERBOSE
+		printf("------------- localSize = %3zu, bandwidth = %7.3lf GB/s\n",
+			   localSize, memops * NTIMES * arraySize * sizeof(float) / 1024.0 / 1024.0 / 1024.0 / (time));
+#endif
+	}
+
+	printf("%18s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %19zu   %11.3lf",
+		   testName, memops * NTIMES * arraySize * dataType / 1024.0 / 1024.0 / 1024.0 / bestTime, totalTime / NTIMES,
+		   bestTime, worstTime, bestLocalSize, flops * NTIMES * arraySize / 1.0e9 / bestTime);
+	TraceHostSpan(testName, testStart, GetWallTime());
+#ifdef RESOURCEREPORT
+	PrintKernelResources(queue, kernel);
+#else
+	printf("\n");
+#endif
+
+	// Keep the result for the roofline
+	if (numResults < MAXRESULTS)
+	{
+		TestResult *result = &results[numResults++];
+		snprintf(result->name, sizeof(result->name), "%s", testName);
+		result->bandwidth = memops * NTIMES * arraySize * dataType / 1024.0 / 1024.0 / 1024.0 / bestTime;
+		result->gflops = flops * NTIMES * arraySize / 1.0e9 / bestTime;
+		result->intensity = (double)flops / (memops * dataType);
+		result->dataType = dataType;
+	}
+#ifdef IDLEANALYSIS
+	AnalyseIdleTime(testName, bestTimes, bestTime, (double)memops * NTIMES * arraySize * dataType);
+#endif
+}
+
+// Compares a sequence of separate kernels against the fused kernel that does the same work,
+// for array sizes from FUSIONMINSIZE up to arraySize. Both are checked to give the same outputs first.
+void RunFusionTest(cl_command_queue *queue, cl_kernel *initKernel, cl_kernel *separateKernels, int numSeparate, int separateMemops,
+				   cl_kernel *fusedKernel, int fusedMemops, cl_mem *outputs, int numOutputs, char *testName, size_t arraySize, size_t dataType)
+{
+	size_t initLocalSize = 64;
+	size_t size = FUSIONMINSIZE < arraySize ? FUSIONMINSIZE : arraySize;
+	cl_context context;
+	cl_int err;
 
-	copyKernelD = clCreateKernel(program, "copyKernelDouble", &err);
-	copyKernelF = clCreateKernel(program, "copyKernelFloat", &err);
+	// Run each version once from the initial values, keeping the separate outputs to compare
+	clGetCommandQueueInfo(*queue, CL_QUEUE_CONTEXT, sizeof(context), &context, NULL);
+	cl_mem *expected = malloc(numOutputs * sizeof(cl_mem));
+	for (int i = 0; i < numOutputs; i++)
+		expected[i] = clCreateBuffer(context, CL_MEM_READ_WRITE, size * dataType, NULL, &err);
 	CheckOpenCLError(err, __LINE__);
-	scaleKernelD = clCreateKernel(program, "scaleKernelDouble", &err);
-	scaleKernelF = clCreateKernel(program, "scaleKernelFloat", &err);
+
+	err = clEnqueueNDRangeKernel(*queue, *initKernel, 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+	for (int k = 0; k < numSeparate; k++)
+		err |= clEnqueueNDRangeKernel(*queue, separateKernels[k], 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+	for (int i = 0; i < numOutputs; i++)
+		err |= clEnqueueCopyBuffer(*queue, outputs[i], expected[i], 0, 0, size * dataType, 0, NULL, NULL);
+	err |= clEnqueueNDRangeKernel(*queue, *initKernel, 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+	err |= clEnqueueNDRangeKernel(*queue, *fusedKernel, 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+	clFinish(*queue);
 	CheckOpenCLError(err, __LINE__);
-	addKernelD = clCreateKernel(program, "addKernelDouble", &err);
-	addKernelF = clCreateKernel(program, "addKernelFloat", &err);
+
+	for (int i = 0; i < numOutputs; i++)
+	{
+		if (!CompareDeviceBuffers(queue, &expected[i], &outputs[i], size * dataType))
+			printf("Error in %s, fused output %d differs from the separate kernels!\n", testName, i);
+		clReleaseMemObject(expected[i]);
+	}
+	free(expected);
+
+	for (; size <= arraySize; size *= 4)
+	{
+		double bestSeparate = DBL_MAX, bestFused = DBL_MAX;
+
+		// Same local sizes as RunTest(), each version keeps its best. The arrays are
+		// initialised again before every run so the chained values don't overflow.
+		for (size_t localSize = 16; localSize <= 256; localSize *= 2)
+		{
+			err = clEnqueueNDRangeKernel(*queue, *initKernel, 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+			clFinish(*queue);
+			CheckOpenCLError(err, __LINE__);
+			double time = TimeKernelSequence(queue, separateKernels, numSeparate, size, localSize);
+			if (time < bestSeparate)
+				bestSeparate = time;
+
+			err = clEnqueueNDRangeKernel(*queue, *initKernel, 1, NULL, &size, &initLocalSize, 0, NULL, NULL);
+			clFinish(*queue);
+			CheckOpenCLError(err, __LINE__);
+			time = TimeKernelSequence(queue, fusedKernel, 1, size, localSize);
+			if (time < bestFused)
+				bestFused = time;
+		}
+
+		printf("%18s   %10zu   %13.6lf   %10.6lf   %7.3lf   %14.3lfMB   %19d   %10.3lf\n",
+			   testName, size, bestSeparate, bestFused, bestSeparate / bestFused,
+			   (separateMemops - fusedMemops) * size * dataType / 1024.0 / 1024.0, numSeparate - 1,
+			   fusedMemops * NTIMES * size * dataType / 1024.0 / 1024.0 / 1024.0 / bestFused);
+
+		// Make sure the full array size is always tested
+		if (size < arraySize && size * 4 > arraySize)
+			size = arraySize / 4;
+	}
+}
+
+// Records the NTIMES launches of each stream kernel, and of the whole stream sequence, in a command buffer and compares
+// replaying it against enqueueing the launches one by one, for sizes from CMDBUFMINSIZE up to arraySize.
+void RunCommandBufferTests(cl_command_queue *queue, cl_kernel *streamKernels, size_t arraySize)
+{
+	printf("\nCommand buffer replay against individual launches, times are for %d iterations\n", NTIMES);
+	if (!DeviceSupportsExtension(queue, "cl_khr_command_buffer"))
+	{
+		printf("Device does not support cl_khr_command_buffer, skipping command buffer tests\n");
+		return;
+	}
+#ifdef cl_khr_command_buffer
+	const char *names[] = {"copyKernelD", "scaleKernelD", "addKernelD", "triadKernelD"};
+	cl_platform_id platform;
+	cl_device_id device;
+	CommandBufferApi api;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform), &platform, NULL);
+	api.create = clGetExtensionFunctionAddressForPlatform(platform, "clCreateCommandBufferKHR");
+	api.ndRangeKernel = clGetExtensionFunctionAddressForPlatform(platform, "clCommandNDRangeKernelKHR");
+	api.finalize = clGetExtensionFunctionAddressForPlatform(platform, "clFinalizeCommandBufferKHR");
+	api.enqueue = clGetExtensionFunctionAddressForPlatform(platform, "clEnqueueCommandBufferKHR");
+	api.release = clGetExtensionFunctionAddressForPlatform(platform, "clReleaseCommandBufferKHR");
+	if (!api.create || !api.ndRangeKernel || !api.finalize || !api.enqueue || !api.release)
+	{
+		printf("Can't load the cl_khr_command_buffer functions, skipping command buffer tests\n");
+		return;
+	}
+
+	// Devices can refuse queues with some properties, e.g. profiling when tracing
+	cl_int err;
+	cl_command_buffer_khr probe = api.create(1, queue, NULL, &err);
+	if (err != CL_SUCCESS)
+	{
+		printf("Can't create a command buffer on this queue (error %d), skipping command buffer tests\n", err);
+		return;
+	}
+	api.release(probe);
+
+	printf("-----------------------------------------------------------------------------------------------------------------\n");
+	printf("Function             Array size   Launches   Enqueue time   Replay time   Speedup   Saved/launch (us)   Record time\n");
+	printf("-----------------------------------------------------------------------------------------------------------------\n");
+	for (size_t size = CMDBUFMINSIZE < arraySize ? CMDBUFMINSIZE : arraySize; size <= arraySize; size *= 4)
+	{
+		for (int k = 0; k < 4; k++)
+			RunCommandBufferTest(&api, queue, &streamKernels[k], 1, (char *)names[k], size);
+		RunCommandBufferTest(&api, queue, streamKernels, 4, "streamD", size);
+		printf("-----------------------------------------------------------------------------------------------------------------\n");
+
+		// Make sure the full array size is always tested
+		if (size < arraySize && size * 4 > arraySize)
+			size = arraySize / 4;
+	}
+#else
+	printf("Built with OpenCL headers without cl_khr_command_buffer, skipping command buffer tests\n");
+#endif
+}
+
+#ifdef cl_khr_command_buffer
+// The launches are chained with sync points, commands in a command buffer are not ordered otherwise
+void RunCommandBufferTest(CommandBufferApi *api, cl_command_queue *queue, cl_kernel *kernels, int numKernels, char *testName, size_t size)
+{
+	size_t localSize = CMDBUFLOCALSIZE;
+	double bestEnqueue = DBL_MAX, bestReplay = DBL_MAX;
+	cl_sync_point_khr syncPoint, previous;
+	cl_int err;
+
+	double recordTime = GetWallTime();
+	cl_command_buffer_khr commandBuffer = api->create(1, queue, NULL, &err);
 	CheckOpenCLError(err, __LINE__);
-	triadKernelD = clCreateKernel(program, "triadKernelDouble", &err);
-	triadKernelF = clCreateKernel(program, "triadKernelFloat", &err);
+	for (int n = 0; n < NTIMES * numKernels; n++)
+	{
+		err |= api->ndRangeKernel(commandBuffer, NULL, NULL, kernels[n % numKernels], 1, NULL, &size, &localSize,
+								  n > 0 ? 1 : 0, n > 0 ? &previous : NULL, &syncPoint, NULL);
+		previous = syncPoint;
+	}
+	err |= api->finalize(commandBuffer);
 	CheckOpenCLError(err, __LINE__);
+	recordTime = GetWallTime() - recordTime;
 
-	// If the user inputs a size, it will be used. Otherwise, the default size is used.
-	size_t arraySize = TRYARRAYSIZE;
-	if (argc == 2 && atoi(argv[1]) > 256 && atoi(argv[1]) % 16 == 0)
+	// First run of each is a warm up
+	for (int r = 0; r <= CMDBUFRUNS; r++)
 	{
-		arraySize = (size_t)atoi(argv[1]);
-#ifdef VERBOSE
-		printf("Using array size of %zu\n", arraySize);
+		double time = TimeKernelSequence(queue, kernels, numKernels, size, localSize);
+		if (r > 0 && time < bestEnqueue)
+			bestEnqueue = time;
+
+		time = GetWallTime();
+		err = api->enqueue(1, queue, commandBuffer, 0, NULL, NULL);
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+		time = GetWallTime() - time;
+		if (r > 0 && time < bestReplay)
+			bestReplay = time;
+	}
+	api->release(commandBuffer);
+
+	int launches = NTIMES * numKernels;
+	printf("%18s   %10zu   %8d   %12.6lf   %11.6lf   %7.3lf   %17.3lf   %11.6lf\n",
+		   testName, size, launches, bestEnqueue, bestReplay, bestEnqueue / bestReplay,
+		   (bestEnqueue - bestReplay) / launches * 1.0e6, recordTime);
+}
 #endif
+
+void RunSchedulingTests(cl_program *program, cl_command_queue *queue, cl_mem *device_A, cl_mem *device_C, size_t arraySize)
+{
+	const cl_uint hotFactors[] = {1, HOTFACTOR};
+	const cl_uint chunkSizes[] = CHUNKSIZES;
+	const int numChunkSizes = sizeof(chunkSizes) / sizeof(chunkSizes[0]);
+	cl_kernel itemKernel, strideKernel, dynamicKernel;
+	cl_context context;
+	cl_mem counters;
+	char testName[32];
+	cl_int err;
+
+	itemKernel = clCreateKernel(*program, "scheduleItemDouble", &err);
+	strideKernel = clCreateKernel(*program, "scheduleStrideDouble", &err);
+	dynamicKernel = clCreateKernel(*program, "scheduleDynamicDouble", &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// One work counter per launch of the NTIMES loop
+	clGetCommandQueueInfo(*queue, CL_QUEUE_CONTEXT, sizeof(context), &context, NULL);
+	counters = clCreateBuffer(context, CL_MEM_READ_WRITE, NTIMES * sizeof(cl_uint), NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	err = clSetKernelArg(itemKernel, 0, sizeof(cl_mem), device_A);
+	err |= clSetKernelArg(itemKernel, 1, sizeof(cl_mem), device_C);
+	err |= clSetKernelArg(strideKernel, 0, sizeof(cl_mem), device_A);
+	err |= clSetKernelArg(strideKernel, 1, sizeof(cl_mem), device_C);
+	err |= clSetKernelArg(strideKernel, 3, sizeof(unsigned long), &arraySize);
+	err |= clSetKernelArg(dynamicKernel, 0, sizeof(cl_mem), device_A);
+	err |= clSetKernelArg(dynamicKernel, 1, sizeof(cl_mem), device_C);
+	err |= clSetKernelArg(dynamicKernel, 2, sizeof(cl_mem), &counters);
+	err |= clSetKernelArg(dynamicKernel, 5, sizeof(unsigned long), &arraySize);
+	CheckOpenCLError(err, __LINE__);
+
+	for (int h = 0; h < 2; h++)
+	{
+		err = clSetKernelArg(itemKernel, 2, sizeof(cl_uint), &hotFactors[h]);
+		err |= clSetKernelArg(strideKernel, 4, sizeof(cl_uint), &hotFactors[h]);
+		err |= clSetKernelArg(dynamicKernel, 6, sizeof(cl_uint), &hotFactors[h]);
+		CheckOpenCLError(err, __LINE__);
+
+		// Fourth and fifth arguments are the kernel stride and launch index arguments, sixth selects the occupancy sized grid
+		printf("\nScheduling, %s work per element (hot elements do %u times more work)\n", h == 0 ? "uniform" : "skewed", hotFactors[h]);
+		printf("--------------------------------------------------------------------------------------------------------\n");
+		printf("Function               Avg time   Min time   Max time   Best Workgroup Size   Global Size   Speedup\n");
+		printf("--------------------------------------------------------------------------------------------------------\n");
+		double strideTime = RunSchedulingTest(queue, &strideKernel, "stride", 2, -1, 0, &counters, arraySize, 0.0);
+		RunSchedulingTest(queue, &strideKernel, "persistentStride", 2, -1, 1, &counters, arraySize, strideTime);
+		RunSchedulingTest(queue, &itemKernel, "item", -1, -1, 0, &counters, arraySize, strideTime);
+		for (int c = 0; c < numChunkSizes; c++)
+		{
+			err = clSetKernelArg(dynamicKernel, 4, sizeof(cl_uint), &chunkSizes[c]);
+			CheckOpenCLError(err, __LINE__);
+
+			snprintf(testName, sizeof(testName), "dynamic%u", chunkSizes[c]);
+			RunSchedulingTest(queue, &dynamicKernel, testName, -1, 3, 0, &counters, arraySize, strideTime);
+			snprintf(testName, sizeof(testName), "persistentDynamic%u", chunkSizes[c]);
+			RunSchedulingTest(queue, &dynamicKernel, testName, -1, 3, 1, &counters, arraySize, strideTime);
+		}
+		printf("--------------------------------------------------------------------------------------------------------\n");
 	}
 
-	// Sanitize array size of doubles (in case it's bigger than the GPU memory)
-	size_t sizeBytesDouble = arraySize * sizeof(double);
-	SanitizeAndRoundArraySize(&sizeBytesDouble, maxAlloc, globalMemSize, sizeof(double), &arraySize, "doubles");
+	clReleaseMemObject(counters);
+	clReleaseKernel(itemKernel);
+	clReleaseKernel(strideKernel);
+	clReleaseKernel(dynamicKernel);
+}
+
+// Like RunTest(), for the scheduling kernels. The grid is one work-item per element, unless the
+// kernel has a stride or launch argument: then it's CU * WFP * localSize like the stride tests, or
+// with persistent set, just as many work-items as the device can hold at once (one wavefront per
+// wavefront slot). Returns the best time, speedup is printed against baselineTime if given.
+double RunSchedulingTest(cl_command_queue *queue, cl_kernel *kernel, char *testName, int strideIdx, int launchIdx, int persistent,
+						 cl_mem *counters, size_t arraySize, double baselineTime)
+{
+	size_t localSize;
+	size_t bestLocalSize = 0, bestGlobalSize = 0;
+	size_t globalSize = arraySize;
+	size_t wavefrontSize;
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	cl_device_id device;
+	cl_uint zero = 0;
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(wavefrontSize), &wavefrontSize, NULL);
+
+	for (localSize = 16; localSize <= 256; localSize *= 2)
+	{
+		if (strideIdx != -1 || launchIdx != -1)
+		{
+			if (persistent)
+			{
+				globalSize = (CU * WFP * wavefrontSize / localSize) * localSize;
+				if (globalSize < CU * localSize)
+					globalSize = CU * localSize;
+			}
+			else
+				globalSize = CU * WFP * localSize;
+		}
+		if (strideIdx != -1)
+		{
+			err = clSetKernelArg(*kernel, strideIdx, sizeof(unsigned long), &globalSize);
+			CheckOpenCLError(err, __LINE__);
+		}
+
+		// The dynamic kernels need their counters zeroed before every launch
+		err = clEnqueueFillBuffer(*queue, *counters, &zero, sizeof(zero), 0, NTIMES * sizeof(cl_uint), 0, NULL, NULL);
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		double time = GetWallTime();
+
+		for (cl_uint n = 0; n < NTIMES; n++)
+		{
+			if (launchIdx != -1)
+				err |= clSetKernelArg(*kernel, launchIdx, sizeof(cl_uint), &n);
+			err |= clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+		}
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		time = GetWallTime() - time;
+		if (time < bestTime)
+		{
+			bestTime = time;
+			bestLocalSize = localSize;
+			bestGlobalSize = globalSize;
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+	}
+
+	printf("%18s   %10.6lf   %8.6lf   %8.6lf   %19zu   %11zu   ",
+		   testName, totalTime / NTIMES, bestTime, worstTime, bestLocalSize, bestGlobalSize);
+	if (baselineTime > 0.0)
+		printf("%7.3lf\n", baselineTime / bestTime);
+	else
+		printf("%7s\n", "-");
+
+	return bestTime;
+}
+
+// Runs copy and triad on arrays packed in the scratch block of the arena, first moving them apart by growing gaps
+// (every sub-buffer still on the base address alignment), then starting the kernels at an element offset.
+void RunAlignmentSweep(Arena *arena, cl_program *program, cl_command_queue *queue, size_t arraySize)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const cl_double scalarD = 3.0;
+	const cl_float scalarF = 3.0f;
+	const cl_uint elementOffsets[] = {1, 2, 3, 4, 8, 16, MAXELEMENTOFFSET};
+	cl_device_id device;
+	cl_uint baseAlignBits;
+	char kernelName[32];
+	cl_kernel copyKernel, triadKernel;
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	err = clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(baseAlignBits), &baseAlignBits, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint baseAlign = baseAlignBits / 8;
+
+	for (int p = 0; p < 2; p++)
+	{
+		// The three arrays, their largest gaps and offsets must fit in the scratch block of the arena
+		size_t elements = arraySize < ALIGNSWEEPSIZE ? arraySize : ALIGNSWEEPSIZE;
+		while (elements > 256 && 3 * ((elements + MAXELEMENTOFFSET) * typeSizes[p] + baseAlign + MAXALIGNGAP) > arena->scratchBytes)
+		{
+			elements /= 2;
+		}
+
+		snprintf(kernelName, sizeof(kernelName), "offsetCopyKernel%s", precisions[p]);
+		copyKernel = clCreateKernel(*program, kernelName, &err);
+		snprintf(kernelName, sizeof(kernelName), "offsetTriadKernel%s", precisions[p]);
+		triadKernel = clCreateKernel(*program, kernelName, &err);
+		CheckOpenCLError(err, __LINE__);
+
+		err = clSetKernelArg(triadKernel, 3, typeSizes[p], p == 0 ? (const void *)&scalarD : (const void *)&scalarF);
+		CheckOpenCLError(err, __LINE__);
+
+		printf("Alignment sweep, %ss, %zu elements per array, CL_DEVICE_MEM_BASE_ADDR_ALIGN = %u bytes\n",
+			   precisions[p], elements, baseAlign);
+		printf("--------------------------------------------------------------------------------------------------------\n");
+		printf(" Gap bytes   Element offset   Copy GB/s   Triad GB/s   Copy rel   Triad rel\n");
+		printf("--------------------------------------------------------------------------------------------------------\n");
+
+		// Bandwidth of the back to back arrays, every other row is relative to it
+		double baseCopy = 0.0, baseTriad = 0.0;
+
+		// Gap sweep, 0 then powers of 2 of the base alignment
+		for (size_t gap = 0; gap <= MAXALIGNGAP; gap = (gap == 0) ? baseAlign : gap * 2)
+		{
+			double copy = 2 * NTIMES * elements * typeSizes[p] / 1024.0 / 1024.0 / 1024.0 /
+						  RunAlignmentTest(&arena->scratch, queue, &copyKernel, 2, typeSizes[p], elements, gap, 0, baseAlign);
+			double triad = 3 * NTIMES * elements * typeSizes[p] / 1024.0 / 1024.0 / 1024.0 /
+						   RunAlignmentTest(&arena->scratch, queue, &triadKernel, 3, typeSizes[p], elements, gap, 0, baseAlign);
+			if (gap == 0)
+			{
+				baseCopy = copy;
+				baseTriad = triad;
+			}
+			printf("%10zu   %14u   %9.3lf   %10.3lf   %8.3lf   %9.3lf\n", gap, 0, copy, triad, copy / baseCopy, triad / baseTriad);
+		}
+		printf("--------------------------------------------------------------------------------------------------------\n");
+
+		// Element offset sweep, arrays back to back
+		for (int o = 0; o < (int)(sizeof(elementOffsets) / sizeof(elementOffsets[0])); o++)
+		{
+			double copy = 2 * NTIMES * elements * typeSizes[p] / 1024.0 / 1024.0 / 1024.0 /
+						  RunAlignmentTest(&arena->scratch, queue, &copyKernel, 2, typeSizes[p], elements, 0, elementOffsets[o], baseAlign);
+			double triad = 3 * NTIMES * elements * typeSizes[p] / 1024.0 / 1024.0 / 1024.0 /
+						   RunAlignmentTest(&arena->scratch, queue, &triadKernel, 3, typeSizes[p], elements, 0, elementOffsets[o], baseAlign);
+			printf("%10d   %14u   %9.3lf   %10.3lf   %8.3lf   %9.3lf\n", 0, elementOffsets[o], copy, triad, copy / baseCopy, triad / baseTriad);
+		}
+		printf("--------------------------------------------------------------------------------------------------------\n");
+
+		clReleaseKernel(copyKernel);
+		clReleaseKernel(triadKernel);
+	}
+}
+
+// Carves numArrays arrays of elements + MAXELEMENTOFFSET items out of the parent buffer, gapBytes apart and every one
+// on the base address alignment, binds them in order to the first kernel arguments and returns the best time
+// of NTIMES launches over the local sizes. The element offset is the last kernel argument.
+double RunAlignmentTest(cl_mem *parent, cl_command_queue *queue, cl_kernel *kernel, int numArrays, size_t typeSize,
+						size_t elements, size_t gapBytes, cl_uint elementOffset, cl_uint baseAlign)
+{
+	cl_mem arrays[3];
+	cl_buffer_region region;
+	cl_uint numArgs;
+	cl_int err;
+
+	// Sub-buffer origins must be a multiple of the base alignment, gaps already are
+	size_t arrayBytes = (elements + MAXELEMENTOFFSET) * typeSize;
+	size_t slotBytes = ((arrayBytes + baseAlign - 1) / baseAlign) * baseAlign + gapBytes;
+
+	// Every array is filled with ones, triad only ever writes B + 3 * C back to A
+	if (typeSize == sizeof(cl_double))
+	{
+		const cl_double one = 1.0;
+		err = clEnqueueFillBuffer(*queue, *parent, &one, sizeof(one), 0, numArrays * slotBytes, 0, NULL, NULL);
+	}
+	else
+	{
+		const cl_float one = 1.0f;
+		err = clEnqueueFillBuffer(*queue, *parent, &one, sizeof(one), 0, numArrays * slotBytes, 0, NULL, NULL);
+	}
+	CheckOpenCLError(err, __LINE__);
+
+	for (int i = 0; i < numArrays; i++)
+	{
+		region.origin = i * slotBytes;
+		region.size = arrayBytes;
+		arrays[i] = clCreateSubBuffer(*parent, CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+		CheckOpenCLError(err, __LINE__);
+		err = clSetKernelArg(*kernel, i, sizeof(cl_mem), &arrays[i]);
+	}
+	err |= clGetKernelInfo(*kernel, CL_KERNEL_NUM_ARGS, sizeof(numArgs), &numArgs, NULL);
+	err |= clSetKernelArg(*kernel, numArgs - 1, sizeof(cl_uint), &elementOffset);
+	CheckOpenCLError(err, __LINE__);
+	clFinish(*queue);
+
+	double bestTime = DBL_MAX;
+	for (size_t localSize = 16; localSize <= 256; localSize *= 2)
+	{
+		double time = TimeKernelSequence(queue, kernel, 1, elements, localSize);
+		if (time < bestTime)
+		{
+			bestTime = time;
+		}
+	}
+
+	for (int i = 0; i < numArrays; i++)
+	{
+		clReleaseMemObject(arrays[i]);
+	}
+
+	return bestTime;
+}
+
+// Runs the kernels one after the other NTIMES times and returns the wall time
+double TimeKernelSequence(cl_command_queue *queue, cl_kernel *kernels, int numKernels, size_t globalSize, size_t localSize)
+{
+	cl_int err = CL_SUCCESS;
+	cl_event *events = malloc(NTIMES * numKernels * sizeof(cl_event));
+
+	double time = GetWallTime();
+	for (int n = 0; n < NTIMES; n++)
+	{
+		for (int k = 0; k < numKernels; k++)
+			err |= clEnqueueNDRangeKernel(*queue, kernels[k], 1, NULL, &globalSize, &localSize, 0, NULL, TRACE_EVENT(&events[n * numKernels + k]));
+	}
+	clFinish(*queue);
+	CheckOpenCLError(err, __LINE__);
+	time = GetWallTime() - time;
+
+#if defined(TRACE) || defined(IDLEANALYSIS)
+	for (int k = 0; k < numKernels; k++)
+	{
+		char kernelName[48];
+		cl_ulong times[4];
+		clGetKernelInfo(kernels[k], CL_KERNEL_FUNCTION_NAME, sizeof(kernelName), kernelName, NULL);
+		for (int n = 0; n < NTIMES; n++)
+		{
+			ReadCommandTimes(events[n * numKernels + k], times);
+			TraceCommand(times, kernelName, localSize);
+		}
+	}
+#endif
+	free(events);
+	return time;
+}
+
+// Enqueues one copy of size elements of dataType from src to dst with the given command, or a fill of dst with ones.
+// Returns the bytes read and written, 0 (and nothing is enqueued) when the array is too small for the rectangle.
+size_t EnqueueCopyApi(cl_command_queue *queue, int api, cl_mem *src, cl_mem *dst, size_t size, size_t dataType, cl_event *event)
+{
+	const cl_double oneD = 1.0;
+	const cl_float oneF = 1.0f;
+	size_t origin[3] = {0, 0, 0};
+	size_t region[3];
+	size_t bytes = 0;
+	cl_int err = CL_SUCCESS;
+
+	switch (api)
+	{
+	case COPYAPI_BUFFER:
+		err = clEnqueueCopyBuffer(*queue, *src, *dst, 0, 0, size * dataType, 0, NULL, event);
+		bytes = 2 * size * dataType;
+		break;
+	case COPYAPI_RECT2D:
+		// Left half of every row
+		region[0] = COPYRECTWIDTH / 2 * dataType;
+		region[1] = size / COPYRECTWIDTH;
+		region[2] = 1;
+		if (region[1] == 0)
+			return 0;
+		err = clEnqueueCopyBufferRect(*queue, *src, *dst, origin, origin, region, COPYRECTWIDTH * dataType, 0,
+									  COPYRECTWIDTH * dataType, 0, 0, NULL, event);
+		bytes = 2 * region[0] * region[1];
+		break;
+	case COPYAPI_RECT3D:
+		// Top left quarter of every slice
+		region[0] = COPYRECTSIDE / 2 * dataType;
+		region[1] = COPYRECTSIDE / 2;
+		region[2] = size / (COPYRECTSIDE * COPYRECTSIDE);
+		if (region[2] == 0)
+			return 0;
+		err = clEnqueueCopyBufferRect(*queue, *src, *dst, origin, origin, region, COPYRECTSIDE * dataType, COPYRECTSIDE * COPYRECTSIDE * dataType,
+									  COPYRECTSIDE * dataType, COPYRECTSIDE * COPYRECTSIDE * dataType, 0, NULL, event);
+		bytes = 2 * region[0] * region[1] * region[2];
+		break;
+	case COPYAPI_FILL:
+		err = clEnqueueFillBuffer(*queue, *dst, dataType == sizeof(cl_double) ? (const void *)&oneD : (const void *)&oneF, dataType,
+								  0, size * dataType, 0, NULL, event);
+		bytes = size * dataType;
+		break;
+	}
+	CheckOpenCLError(err, __LINE__);
+
+	return bytes;
+}
+
+// Same as RunTest() for a copy or fill command: NTIMES enqueues, repeated COPYAPIRUNS times. There is no work-group size.
+void RunCopyApiTest(cl_command_queue *queue, int api, char *testName, cl_mem *src, cl_mem *dst, size_t arraySize, size_t dataType)
+{
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	double testStart = GetWallTime();
+	size_t bytes = 0;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+	cl_event events[NTIMES];
+	cl_ulong times[NTIMES][4], bestTimes[NTIMES][4];
+#endif
+
+	for (int r = 0; r < COPYAPIRUNS; r++)
+	{
+		double time = GetWallTime();
+
+		for (int n = 0; n < NTIMES; n++)
+		{
+			bytes = EnqueueCopyApi(queue, api, src, dst, arraySize, dataType, TRACE_EVENT(&events[n]));
+			if (bytes == 0)
+			{
+				printf("%18s   array too small for the rectangle\n", testName);
+				return;
+			}
+		}
+		clFinish(*queue);
+
+		time = GetWallTime() - time;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+		for (int n = 0; n < NTIMES; n++)
+		{
+			ReadCommandTimes(events[n], times[n]);
+			TraceCommand(times[n], testName, 0);
+		}
+#endif
+		if (time < bestTime)
+		{
+			bestTime = time;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+			memcpy(bestTimes, times, sizeof(times));
+#endif
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+	}
+
+	double bandwidth = (double)NTIMES * bytes / 1024.0 / 1024.0 / 1024.0 / bestTime;
+	printf("%18s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %19s   %11.3lf\n",
+		   testName, bandwidth, totalTime / NTIMES, bestTime, worstTime, "-", 0.0);
+	TraceHostSpan(testName, testStart, GetWallTime());
+
+	// Not kept for the roofline: a fill only writes, so it can beat every kernel and isn't a peak they can reach
+#ifdef IDLEANALYSIS
+	AnalyseIdleTime(testName, bestTimes, bestTime, (double)NTIMES * bytes);
+#endif
+}
+
+// Best time of NTIMES copy or fill commands of size elements, over COPYAPIRUNS runs. 0 when the array is too small.
+double TimeCopyApi(cl_command_queue *queue, int api, cl_mem *src, cl_mem *dst, size_t size, size_t dataType)
+{
+	double bestTime = DBL_MAX;
+
+	for (int r = 0; r < COPYAPIRUNS; r++)
+	{
+		double time = GetWallTime();
+		for (int n = 0; n < NTIMES; n++)
+		{
+			if (EnqueueCopyApi(queue, api, src, dst, size, dataType, NULL) == 0)
+				return 0.0;
+		}
+		clFinish(*queue);
+		time = GetWallTime() - time;
+		if (time < bestTime)
+		{
+			bestTime = time;
+		}
+	}
+
+	return bestTime;
+}
+
+// GB/s of copyKernelD and elementwiseCopyD (best local size) against every copy and fill command, with Doubles, from
+// COPYMINSIZE elements up to the array size. The rectangular copies move less data, their GB/s is over what they move.
+void RunCopyApiSweep(cl_command_queue *queue, cl_mem *device_A, cl_mem *device_C, size_t arraySize)
+{
+	cl_kernel kernels[] = {MainKernel("copyKernelD"), MainKernel("elementwiseCopyD")};
+
+	printf("\nCopy kernels against copy and fill commands (GB/s), Doubles, %d iterations\n", NTIMES);
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Array size   copyKernelD   elementwiseCopyD   copyBuffer   copyRect2D   copyRect3D   fillBuffer\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	for (size_t size = COPYMINSIZE < arraySize ? COPYMINSIZE : arraySize; size <= arraySize; size *= 4)
+	{
+		printf("%10zu", size);
+		for (int k = 0; k < 2; k++)
+		{
+			double bestTime = DBL_MAX;
+			for (size_t localSize = 16; localSize <= 256 && kernels[k] != NULL; localSize *= 2)
+			{
+				double time = TimeKernelSequence(queue, &kernels[k], 1, size, localSize);
+				if (time < bestTime)
+				{
+					bestTime = time;
+				}
+			}
+			if (kernels[k] != NULL)
+				printf("   %*.3lf", k == 0 ? 11 : 16, 2.0 * NTIMES * size * sizeof(cl_double) / 1024.0 / 1024.0 / 1024.0 / bestTime);
+			else
+				printf("   %*s", k == 0 ? 11 : 16, "-");
+		}
+		for (int api = 0; api < NUMCOPYAPIS; api++)
+		{
+			// Bytes moved by one command (enqueued once more as a warm up), the time is for NTIMES of them
+			size_t bytes = EnqueueCopyApi(queue, api, device_A, device_C, size, sizeof(cl_double), NULL);
+			double time = TimeCopyApi(queue, api, device_A, device_C, size, sizeof(cl_double));
+			if (time > 0.0)
+				printf("   %10.3lf", (double)NTIMES * bytes / 1024.0 / 1024.0 / 1024.0 / time);
+			else
+				printf("   %10s", "-");
+		}
+		printf("\n");
+	}
+	printf("--------------------------------------------------------------------------------------------------------\n");
+}
+
+// Runs NTIMES copy commands of A into B on a second queue alongside NTIMES launches of peakFmaDouble1 writing C, and
+// compares the wall time against each of them alone. The kernel's global size is set so it takes about as long as the
+// copies. Overlap is the time saved over running them one after the other, as a % of the shorter of the two.
+void RunCopyOverlapTest(cl_program *program, cl_command_queue *queue, cl_mem *device_A, cl_mem *device_B, cl_mem *device_C, size_t arraySize)
+{
+	cl_context context;
+	cl_device_id device;
+	cl_command_queue copyQueue;
+	cl_kernel kernel;
+	size_t localSize = 256;
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_CONTEXT, sizeof(context), &context, NULL);
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	copyQueue = clCreateCommandQueue(context, device, 0, &err);
+	CheckOpenCLError(err, __LINE__);
+	kernel = clCreateKernel(*program, "peakFmaDouble1", &err);
+	CheckOpenCLError(err, __LINE__);
+	err = clSetKernelArg(kernel, 0, sizeof(cl_mem), device_C);
+	CheckOpenCLError(err, __LINE__);
+
+	// Alone, the kernel first at the array size to size it like the copies
+	double copyTime = TimeCopyApi(&copyQueue, COPYAPI_BUFFER, device_A, device_B, arraySize, sizeof(cl_double));
+	double kernelTime = TimeKernelSequence(queue, &kernel, 1, arraySize, localSize);
+	size_t globalSize = (size_t)(arraySize * (copyTime / kernelTime)) / localSize * localSize;
+	if (globalSize < localSize)
+		globalSize = localSize;
+	if (globalSize > arraySize)
+		globalSize = arraySize;
+	kernelTime = TimeKernelSequence(queue, &kernel, 1, globalSize, localSize);
+
+	// Both at once, best of COPYAPIRUNS
+	double bothTime = DBL_MAX;
+	for (int r = 0; r < COPYAPIRUNS; r++)
+	{
+		double time = GetWallTime();
+		err = CL_SUCCESS;
+		for (int n = 0; n < NTIMES; n++)
+		{
+			EnqueueCopyApi(&copyQueue, COPYAPI_BUFFER, device_A, device_B, arraySize, sizeof(cl_double), NULL);
+			err |= clEnqueueNDRangeKernel(*queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+		}
+		clFlush(copyQueue);
+		clFlush(*queue);
+		clFinish(copyQueue);
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+		time = GetWallTime() - time;
+		if (time < bothTime)
+		{
+			bothTime = time;
+		}
+	}
+
+	double shorter = copyTime < kernelTime ? copyTime : kernelTime;
+	double overlap = (copyTime + kernelTime - bothTime) / shorter * 100.0;
+	if (overlap < 0.0)
+		overlap = 0.0;
+
+	printf("\nCopy command on a second queue alongside a compute kernel, %d iterations of each\n", NTIMES);
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Copy elements   Kernel work-items   Copy alone   Kernel alone       Both   Serial sum   Overlap %%\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("%13zu   %17zu   %10.6lf   %12.6lf   %8.6lf   %10.6lf   %9.1lf\n", arraySize, globalSize, copyTime, kernelTime, bothTime,
+		   copyTime + kernelTime, overlap);
+	printf("--------------------------------------------------------------------------------------------------------\n");
+
+	clReleaseKernel(kernel);
+	clReleaseCommandQueue(copyQueue);
+}
+
+// Runs the triad index variants on arrays of arraySize minus every one of INDEXTAILS elements, Doubles and Floats. Cost is the
+// time per element over the one of the 64-bit unguarded kernel on the whole array.
+void RunIndexTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const char *suffixes[] = {"", "Guarded", "Stride"};
+	const int bits[] = {64, 32};
+	const size_t tails[] = INDEXTAILS;
+	const cl_double scalarD = 3.0;
+	const cl_float scalarF = 3.0f;
+	char kernelName[48];
+	cl_kernel kernels[2][NUMINDEXHANDLINGS];
+	cl_int err;
+
+	printf("\nIndex width and bounds checks, triad, %d iterations\n", NTIMES);
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Function                        Elements   Handling    Best Rate GB/s   Min time   Best Workgroup Size   Cost\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	for (int p = 0; p < 2; p++)
+	{
+		cl_mem *buffers = typeSizes[p] == sizeof(cl_double) ? doubleBuffers : floatBuffers;
+
+		for (int b = 0; b < 2; b++)
+		{
+			for (int h = 0; h < NUMINDEXHANDLINGS; h++)
+			{
+				snprintf(kernelName, sizeof(kernelName), "indexTriad%s%d%s", precisions[p], bits[b], suffixes[h]);
+				kernels[b][h] = clCreateKernel(*program, kernelName, &err);
+				CheckOpenCLError(err, __LINE__);
+
+				err = clSetKernelArg(kernels[b][h], 0, sizeof(cl_mem), &buffers[0]);
+				err |= clSetKernelArg(kernels[b][h], 1, sizeof(cl_mem), &buffers[1]);
+				err |= clSetKernelArg(kernels[b][h], 2, sizeof(cl_mem), &buffers[2]);
+				err |= clSetKernelArg(kernels[b][h], 3, typeSizes[p], p == 0 ? (const void *)&scalarD : (const void *)&scalarF);
+				CheckOpenCLError(err, __LINE__);
+			}
+		}
+
+		double baseTime = 0.0;
+		for (int t = 0; t < (int)(sizeof(tails) / sizeof(tails[0])); t++)
+		{
+			size_t size = arraySize - tails[t];
+
+			for (int b = 0; b < 2; b++)
+			{
+				// The 32-bit kernels can't index past 4G elements
+				if (bits[b] == 32 && size > 0xFFFFFFFFUL)
+				{
+					continue;
+				}
+
+				cl_uint size32 = (cl_uint)size;
+				cl_ulong size64 = size;
+				for (int h = 0; h < NUMINDEXHANDLINGS; h++)
+				{
+					err = clSetKernelArg(kernels[b][h], 4, bits[b] == 32 ? sizeof(size32) : sizeof(size64),
+										 bits[b] == 32 ? (const void *)&size32 : (const void *)&size64);
+					CheckOpenCLError(err, __LINE__);
+
+					size_t bestLocalSize;
+					double time = RunIndexTest(queue, &kernels[b][h], h, size, &bestLocalSize);
+					if (baseTime == 0.0)
+					{
+						baseTime = time;
+					}
+
+					const char *handling = h == INDEX_GUARDED ? "guarded" : h == INDEX_STRIDE ? "stride" : tails[t] == 0 ? "unguarded" : "peeled";
+					snprintf(kernelName, sizeof(kernelName), "indexTriad%s%d%s", precisions[p], bits[b], suffixes[h]);
+					printf("%-28s   %10zu   %-9s   %14.3lf   %8.6lf   %19zu   %4.3lf\n", kernelName, size, handling,
+						   3.0 * NTIMES * size * typeSizes[p] / 1024.0 / 1024.0 / 1024.0 / time, time, bestLocalSize,
+						   (time / size) / (baseTime / arraySize));
+				}
+			}
+		}
+		printf("--------------------------------------------------------------------------------------------------------\n");
+
+		for (int b = 0; b < 2; b++)
+		{
+			for (int h = 0; h < NUMINDEXHANDLINGS; h++)
+			{
+				clReleaseKernel(kernels[b][h]);
+			}
+		}
+	}
+}
+
+// Best time of NTIMES launches on size elements over the local sizes. Unguarded kernels get the whole work-groups and,
+// when the size isn't a multiple of the local size, a second launch of one work-group for the tail (starting at the
+// global offset where the first one ends). Guarded ones get the size rounded up to the local size, stride ones the
+// usual CU * WFP * localSize grid.
+double RunIndexTest(cl_command_queue *queue, cl_kernel *kernel, int handling, size_t size, size_t *bestLocalSize)
+{
+	double bestTime = DBL_MAX;
+	cl_int err = CL_SUCCESS;
+
+	for (size_t localSize = 16; localSize <= 256; localSize *= 2)
+	{
+		size_t globalSize, tailOffset = 0, tailSize = 0;
+
+		switch (handling)
+		{
+		case INDEX_UNGUARDED:
+			globalSize = size / localSize * localSize;
+			tailOffset = globalSize;
+			tailSize = size - globalSize;
+			break;
+		case INDEX_GUARDED:
+			globalSize = (size + localSize - 1) / localSize * localSize;
+			break;
+		default:
+			globalSize = CU * WFP * localSize;
+			break;
+		}
+
+		double time = GetWallTime();
+		for (int n = 0; n < NTIMES; n++)
+		{
+			if (globalSize > 0)
+				err |= clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+			if (tailSize > 0)
+				err |= clEnqueueNDRangeKernel(*queue, *kernel, 1, &tailOffset, &tailSize, &tailSize, 0, NULL, NULL);
+		}
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+		time = GetWallTime() - time;
+
+		if (time < bestTime)
+		{
+			bestTime = time;
+			*bestLocalSize = localSize;
+		}
+	}
+
+	return bestTime;
+}
+
+// Returns 1 if the first sizeBytes of both buffers are identical
+int CompareDeviceBuffers(cl_command_queue *queue, cl_mem *expected, cl_mem *actual, size_t sizeBytes)
+{
+	double spanStart = GetWallTime();
+	char *hostExpected = malloc(sizeBytes);
+	char *hostActual = malloc(sizeBytes);
+
+	clEnqueueReadBuffer(*queue, *expected, CL_TRUE, 0, sizeBytes, hostExpected, 0, NULL, NULL);
+	clEnqueueReadBuffer(*queue, *actual, CL_TRUE, 0, sizeBytes, hostActual, 0, NULL, NULL);
+	int equal = memcmp(hostExpected, hostActual, sizeBytes) == 0;
+
+	free(hostExpected);
+	free(hostActual);
+	TraceHostSpan("CompareDeviceBuffers", spanStart, GetWallTime());
+	return equal;
+}
+
+// Adds a span of the host to the trace, when tracing
+void TraceHostSpan(const char *name, double start, double end)
+{
+	TraceAddSpan(name, TRACE_HOST, start, end, 0);
+}
+
+void TraceAddSpan(const char *name, int row, double start, double end, size_t localSize)
+{
+#ifdef TRACE
+	if (numTraceSpans == MAXTRACESPANS)
+	{
+		printf("Trace full, MAXTRACESPANS spans kept\n");
+		numTraceSpans++;
+	}
+	if (numTraceSpans > MAXTRACESPANS)
+		return;
+
+	TraceSpan *span = &traceSpans[numTraceSpans++];
+	snprintf(span->name, sizeof(span->name), "%s", name);
+	span->row = row;
+	span->start = start;
+	span->end = end;
+	span->localSize = localSize;
+#endif
+}
+
+// Device timestamps have their own origin. QUEUED is taken when the command is enqueued,
+// so enqueueing a marker right after reading the host clock lines both clocks up.
+void TraceCalibrate(cl_command_queue *queue)
+{
+	cl_event marker;
+	cl_ulong queued;
+
+	double host = GetWallTime();
+	cl_int err = clEnqueueMarkerWithWaitList(*queue, 0, NULL, &marker);
+	clFinish(*queue);
+	err |= clGetEventProfilingInfo(marker, CL_PROFILING_COMMAND_QUEUED, sizeof(queued), &queued, NULL);
+	CheckOpenCLError(err, __LINE__);
+	clReleaseEvent(marker);
+
+	traceOffset = host - queued * 1.0e-9;
+}
+
+// Reads the QUEUED, SUBMIT, START and END times of a finished command, in ns, and releases its event
+void ReadCommandTimes(cl_event event, cl_ulong *times)
+{
+	const cl_profiling_info points[] = {CL_PROFILING_COMMAND_QUEUED, CL_PROFILING_COMMAND_SUBMIT,
+										CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END};
+	cl_int err = CL_SUCCESS;
+
+	for (int i = 0; i < 4; i++)
+		err |= clGetEventProfilingInfo(event, points[i], sizeof(cl_ulong), &times[i], NULL);
+	CheckOpenCLError(err, __LINE__);
+	clReleaseEvent(event);
+}
+
+// Adds a finished command to the trace, as its time queued, submitted and running
+void TraceCommand(const cl_ulong *times, const char *name, size_t localSize)
+{
+	// QUEUED to SUBMIT, SUBMIT to START and START to END
+	for (int row = TRACE_QUEUED; row <= TRACE_RUNNING; row++)
+		TraceAddSpan(name, row, traceOffset + times[row - 1] * 1.0e-9, traceOffset + times[row] * 1.0e-9, localSize);
+}
+
+// Writes the trace as Chrome trace events, one complete event ("X") per span, times in microseconds from the start
+void WriteTrace(void)
+{
+	const char *rowNames[TRACE_ROWS] = {"host", "queued (QUEUED to SUBMIT)", "submitted (SUBMIT to START)", "running (START to END)"};
+	int numSpans = numTraceSpans < MAXTRACESPANS ? numTraceSpans : MAXTRACESPANS;
+
+	FILE *file = fopen(TRACEFILE, "w");
+	if (file == NULL)
+	{
+		printf("Can't write the trace to %s\n", TRACEFILE);
+		return;
+	}
+
+	fprintf(file, "{\"traceEvents\": [\n");
+	for (int i = 0; i < numSpans; i++)
+	{
+		TraceSpan *span = &traceSpans[i];
+		fprintf(file, "{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3lf, \"dur\": %.3lf",
+				span->name, span->row == TRACE_HOST ? "host" : "device", span->row, (span->start - traceStart) * 1.0e6, (span->end - span->start) * 1.0e6);
+		if (span->localSize)
+			fprintf(file, ", \"args\": {\"localSize\": %zu}", span->localSize);
+		fprintf(file, "},\n");
+	}
+
+	// Row names
+	for (int row = 0; row < TRACE_ROWS; row++)
+		fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}%s\n",
+				row, rowNames[row], row < TRACE_ROWS - 1 ? "," : "");
+	fprintf(file, "],\n\"displayTimeUnit\": \"ns\"}\n");
+	fclose(file);
+
+	printf("Trace of %d spans written to %s\n", numSpans, TRACEFILE);
+}
+
+// Keeps the idle analysis of the NTIMES launches of a test (times as read by ReadCommandTimes()),
+// timed by the host in time seconds while moving bytes bytes
+void AnalyseIdleTime(const char *testName, cl_ulong (*times)[4], double time, double bytes)
+{
+	double gaps[NTIMES];
+	double running = 0.0, latency = 0.0, gapSum = 0.0;
+
+	for (int n = 0; n < NTIMES; n++)
+	{
+		running += (times[n][3] - times[n][2]) * 1.0e-9;
+		latency += (times[n][2] - times[n][0]) * 1.0e-9;
+		// Back to back launches can be reported overlapping by a few ns, that is no gap
+		gaps[n] = 0.0;
+		if (n > 0 && times[n][2] > times[n - 1][3])
+			gaps[n] = (times[n][2] - times[n - 1][3]) * 1.0e-9;
+		gapSum += gaps[n];
+	}
+	qsort(gaps + 1, NTIMES - 1, sizeof(double), CompareDoubles);
+
+	if (numIdleResults == MAXRESULTS)
+		return;
+
+	IdleResult *result = &idleResults[numIdleResults++];
+	snprintf(result->name, sizeof(result->name), "%s", testName);
+	result->bandwidth = bytes / 1024.0 / 1024.0 / 1024.0 / time;
+	result->kernelBandwidth = running > 0.0 ? bytes / 1024.0 / 1024.0 / 1024.0 / running : 0.0;
+	result->busy = running / time;
+	result->meanGap = NTIMES > 1 ? gapSum / (NTIMES - 1) : 0.0;
+	result->p99Gap = gaps[1 + (NTIMES - 1) * 99 / 100];
+	result->meanLatency = latency / NTIMES;
+}
+
+// Prints the idle analysis of every test. When the device is idle most of the timed loop,
+// the GB/s of the test is how fast the host launches kernels, not the memory bandwidth.
+void PrintIdleAnalysis(void)
+{
+	int launchBound = 0;
+
+	printf("\nIdle analysis, best local size of every test. Launch bound when the device is idle more than %.0lf%% of the timed loop\n",
+		   100.0 * IDLETHRESHOLD);
+	printf("---------------------------------------------------------------------------------------------------------------------------\n");
+	printf("Function             Best Rate GB/s   Kernel GB/s   Busy %%   Mean gap (us)   p99 gap (us)   Queued to start (us)   Bound\n");
+	printf("---------------------------------------------------------------------------------------------------------------------------\n");
+	for (int i = 0; i < numIdleResults; i++)
+	{
+		IdleResult *result = &idleResults[i];
+		int idle = 1.0 - result->busy > IDLETHRESHOLD;
+		launchBound += idle;
+
+		printf("%18s   %14.3lf   %11.3lf   %6.2lf   %13.3lf   %12.3lf   %20.3lf   %s\n",
+			   result->name, result->bandwidth, result->kernelBandwidth, 100.0 * result->busy,
+			   result->meanGap * 1.0e6, result->p99Gap * 1.0e6, result->meanLatency * 1.0e6, idle ? "launch" : "device");
+	}
+	printf("---------------------------------------------------------------------------------------------------------------------------\n");
+	if (launchBound)
+		printf("%d of %d tests are launch bound: their Best Rate GB/s measures the kernel launch rate, not the memory bandwidth (see Kernel GB/s)\n",
+			   launchBound, numIdleResults);
+}
+
+int CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// Whether a test of the main table runs, all of them do when none are selected
+int TestSelected(const char *testName)
+{
+	if (numSelectedTests == 0)
+		return 1;
+	for (int i = 0; i < numSelectedTests; i++)
+		if (strcmp(selectedTests[i], testName) == 0)
+			return 1;
+	return 0;
+}
+
+// Kernel of a test of the main table, NULL if it wasn't created
+cl_kernel MainKernel(const char *testName)
+{
+	for (int t = 0; t < numRegistry; t++)
+		if (strcmp(registry[t].testName, testName) == 0)
+			return registry[t].kernel;
+	return NULL;
+}
+
+// Adds a line of a registry (see RegistryEntry). Returns 0 if it isn't valid.
+int ParseRegistryLine(const char *text)
+{
+	const char *roleNames[NUMROLES] = {"in", "out", "inout", "scalar", "stride", "length"};
+	char line[512], word[64];
+	int used;
+
+	snprintf(line, sizeof(line), "%s", text);
+	line[strcspn(line, "#\r\n")] = '\0';
+	if (sscanf(line, "%63s%n", word, &used) != 1)
+		return 1;
+
+	if (strcmp(word, "---") == 0)
+	{
+		if (numRegistry > 0)
+			registry[numRegistry - 1].separator = 1;
+		return 1;
+	}
+	if (strcmp(word, "source") == 0)
+		return sscanf(line + used, "%255s", registrySource) == 1;
+	if (strcmp(word, "options") == 0)
+	{
+		snprintf(registryOptions, sizeof(registryOptions), "%s", line + used);
+		return 1;
+	}
+	if (numRegistry == MAXREGISTRY)
+	{
+		printf("Registry full, MAXREGISTRY kernels kept\n");
+		return 0;
+	}
+
+	RegistryEntry *entry = &registry[numRegistry];
+	memset(entry, 0, sizeof(*entry));
+	if (sscanf(line, "%63s %31s %d %d %d%n", entry->kernelName, entry->testName,
+			   &entry->bytesRead, &entry->bytesWritten, &entry->flops, &used) != 5)
+		return 0;
+
+	char *roles = line + used;
+	while (sscanf(roles, "%63s%n", word, &used) == 1)
+	{
+		int role = 0;
+		while (role < NUMROLES && strcmp(word, roleNames[role]) != 0)
+			role++;
+		if (role == NUMROLES || entry->numRoles == MAXKERNELARGS)
+			return 0;
+		entry->roles[entry->numRoles++] = role;
+		roles += used;
+	}
+
+	numRegistry++;
+	return 1;
+}
+
+int LoadRegistry(const char *fileName)
+{
+	char line[512];
+	int lineNumber = 0;
+
+	FILE *file = fopen(fileName, "r");
+	if (file == NULL)
+	{
+		printf("Error opening registry file %s\n", fileName);
+		return 0;
+	}
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		lineNumber++;
+		if (!ParseRegistryLine(line))
+		{
+			printf("Error in registry file %s, line %d: %s", fileName, lineNumber, line);
+			fclose(file);
+			return 0;
+		}
+	}
+	fclose(file);
+	return 1;
+}
+
+// Sets the arguments of a registry kernel from their roles and clGetKernelArgInfo, and the data type, memops and
+// stride index of its test. Arrays of up to 4 byte elements get the float arrays, of 8 bytes the double ones.
+// Returns 0 if the kernel can't be bound.
+int BindRegistryKernel(RegistryEntry *entry, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize)
+{
+	const cl_double scalarD = 3.0;
+	const cl_float scalarF = 3.0f;
+	const cl_long scalarL = 3;
+	const cl_int scalarI = 3;
+	int usedArrays[3] = {0, 0, 0};
+	cl_uint numArgs;
+
+	cl_int err = clGetKernelInfo(entry->kernel, CL_KERNEL_NUM_ARGS, sizeof(numArgs), &numArgs, NULL);
+	CheckOpenCLError(err, __LINE__);
+	if (entry->numRoles != 0 && entry->numRoles != (int)numArgs)
+	{
+		printf("%s has %u arguments, %d roles given\n", entry->kernelName, numArgs, entry->numRoles);
+		return 0;
+	}
+
+	entry->dataType = 0;
+	entry->strideIdx = -1;
+	for (cl_uint arg = 0; arg < numArgs; arg++)
+	{
+		cl_kernel_arg_address_qualifier address;
+		cl_kernel_arg_type_qualifier typeQualifier;
+		char typeName[64], argName[64];
+		int role;
+
+		err = clGetKernelArgInfo(entry->kernel, arg, CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(address), &address, NULL);
+		err |= clGetKernelArgInfo(entry->kernel, arg, CL_KERNEL_ARG_TYPE_QUALIFIER, sizeof(typeQualifier), &typeQualifier, NULL);
+		err |= clGetKernelArgInfo(entry->kernel, arg, CL_KERNEL_ARG_TYPE_NAME, sizeof(typeName), typeName, NULL);
+		err |= clGetKernelArgInfo(entry->kernel, arg, CL_KERNEL_ARG_NAME, sizeof(argName), argName, NULL);
+		if (err != CL_SUCCESS)
+		{
+			printf("No argument info for %s (error %d), the program must be built with -cl-kernel-arg-info\n", entry->kernelName, err);
+			return 0;
+		}
+
+		int pointer = strchr(typeName, '*') != NULL;
+		int floating = strstr(typeName, "float") != NULL || strstr(typeName, "double") != NULL || strstr(typeName, "half") != NULL;
+		size_t typeSize = ArgTypeSize(typeName);
+		if (entry->numRoles > 0)
+			role = entry->roles[arg];
+		else if (pointer)
+			role = typeQualifier & CL_KERNEL_ARG_TYPE_CONST ? ROLE_IN : ROLE_OUT;
+		else if (strcmp(argName, "stride") == 0)
+			role = ROLE_STRIDE;
+		else
+			role = floating ? ROLE_SCALAR : ROLE_LENGTH;
+
+		if (role <= ROLE_INOUT)
+		{
+			if (!pointer || address != CL_KERNEL_ARG_ADDRESS_GLOBAL || typeSize == 0 || typeSize > sizeof(cl_double))
+			{
+				printf("%s: argument %s (%s) can't be bound to an array\n", entry->kernelName, argName, typeName);
+				return 0;
+			}
+
+			int array = 0;
+			if (argName[0] >= 'A' && argName[0] <= 'C' && argName[1] == '\0' && !usedArrays[argName[0] - 'A'])
+				array = argName[0] - 'A';
+			else
+				while (array < 3 && usedArrays[array])
+					array++;
+			if (array == 3)
+			{
+				printf("%s: only 3 arrays can be bound\n", entry->kernelName);
+				return 0;
+			}
+			usedArrays[array] = 1;
+			if (entry->dataType == 0)
+				entry->dataType = typeSize;
+			err = clSetKernelArg(entry->kernel, arg, sizeof(cl_mem), typeSize > sizeof(cl_float) ? &doubleBuffers[array] : &floatBuffers[array]);
+		}
+		else if (role == ROLE_SCALAR && (typeSize == sizeof(cl_double) || typeSize == sizeof(cl_float)))
+		{
+			const void *value = floating ? (typeSize == sizeof(cl_double) ? (void *)&scalarD : (void *)&scalarF)
+										 : (typeSize == sizeof(cl_long) ? (void *)&scalarL : (void *)&scalarI);
+			err = clSetKernelArg(entry->kernel, arg, typeSize, value);
+		}
+		else if (role == ROLE_STRIDE && typeSize == sizeof(cl_ulong))
+		{
+			entry->strideIdx = arg;
+		}
+		else if (role == ROLE_LENGTH && (typeSize == sizeof(cl_ulong) || typeSize == sizeof(cl_uint)))
+		{
+			cl_ulong length = arraySize;
+			cl_uint length32 = (cl_uint)arraySize;
+			err = clSetKernelArg(entry->kernel, arg, typeSize, typeSize == sizeof(cl_ulong) ? (void *)&length : (void *)&length32);
+		}
+		else
+		{
+			printf("%s: argument %s (%s) can't be bound as %s\n", entry->kernelName, argName, typeName,
+				   role == ROLE_SCALAR ? "scalar" : role == ROLE_STRIDE ? "stride (must be a ulong)" : "length");
+			return 0;
+		}
+		CheckOpenCLError(err, __LINE__);
+	}
+
+	if (entry->dataType == 0)
+	{
+		printf("%s has no arrays\n", entry->kernelName);
+		return 0;
+	}
+	entry->memops = (entry->bytesRead + entry->bytesWritten) / entry->dataType;
+	if ((entry->bytesRead + entry->bytesWritten) % entry->dataType != 0)
+		printf("%s: bytes per item are not a multiple of its %zu byte elements, bandwidth is rounded down\n", entry->kernelName, entry->dataType);
+	return 1;
+}
+
+// Size of a kernel argument type as given by CL_KERNEL_ARG_TYPE_NAME (the pointed type for pointers), 0 if unknown
+size_t ArgTypeSize(const char *typeName)
+{
+	const char *names[] = {"char", "uchar", "short", "ushort", "half", "int", "uint", "float", "long", "ulong", "double"};
+	const size_t sizes[] = {1, 1, 2, 2, 2, 4, 4, 4, 8, 8, 8};
+	char base[64];
+	int length = 0;
+
+	while (typeName[length] >= 'a' && typeName[length] <= 'z' && length < 63)
+	{
+		base[length] = typeName[length];
+		length++;
+	}
+	base[length] = '\0';
+
+	// Vectors end in their width, 3 element vectors take 4
+	int width = atoi(typeName + length);
+	width = width == 0 ? 1 : width == 3 ? 4 : width;
+	for (int i = 0; i < 11; i++)
+		if (strcmp(base, names[i]) == 0)
+			return sizes[i] * width;
+	return 0;
+}
+
+// clCreateKernel, timed as a start up phase
+cl_kernel CreateKernel(cl_program program, const char *kernelName)
+{
+	char phaseName[48];
+	cl_int err;
+
+	double start = GetWallTime();
+	cl_kernel kernel = clCreateKernel(program, kernelName, &err);
+	CheckOpenCLError(err, __LINE__);
 
-	size_t sizeBytesFloat = arraySize * sizeof(float);
-	SanitizeAndRoundArraySize(&sizeBytesFloat, maxAlloc, globalMemSize, sizeof(float), &arraySize, "floats");
+	snprintf(phaseName, sizeof(phaseName), "clCreateKernel %s", kernelName);
+	AddStartupPhase(phaseName, start, GetWallTime());
+	return kernel;
+}
 
-	// Assign double variables to the device
-	device_dA = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesDouble, NULL, &err);
-	device_dB = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesDouble, NULL, &err);
-	device_dC = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesDouble, NULL, &err);
+// Keeps the time of a start up phase, until the first kernel runs. Every phase is also a span of the trace.
+void AddStartupPhase(const char *name, double start, double end)
+{
+	TraceHostSpan(name, start, end);
+	if (startupTime > 0.0 || numStartupPhases == MAXSTARTUPPHASES)
+		return;
 
-	// Assign float variables to the device
-	device_fA = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesFloat, NULL, &err);
-	device_fB = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesFloat, NULL, &err);
-	device_fC = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeBytesFloat, NULL, &err);
+	StartupPhase *phase = &startupPhases[numStartupPhases++];
+	snprintf(phase->name, sizeof(phase->name), "%s", name);
+	phase->time = end - start;
+}
 
-	// Set kernel arguemnts. Scale and Triad kernels involve multiplication by a scalar:
-	const double scalarD = 3.0;
-	const float scalarF = 3.0f;
+// Prints the start up phases and writes them to STARTUPFILE. Other is the time in between phases
+// (process start up to the first phase, printing, choosing the device, setting arguments).
+void PrintStartupProfile(void)
+{
+	double phasesTime = 0.0;
 
-	// Assign variables to different kernels
-	// initialiseDoubleArraysKernel
-	err = clSetKernelArg(initDoubleArrays, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(initDoubleArrays, 1, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(initDoubleArrays, 2, sizeof(cl_mem), &device_dC);
-
-	// initialiseFloatArraysKernel
-	err |= clSetKernelArg(initFloatArrays, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(initFloatArrays, 1, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(initFloatArrays, 2, sizeof(cl_mem), &device_fC);
-
-	// elementwiseDoubleStride
-	err |= clSetKernelArg(elementwiseDS, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(elementwiseDS, 1, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(elementwiseDS, 2, sizeof(cl_mem), &device_dC);
-	err |= clSetKernelArg(elementwiseDS, 4, sizeof(unsigned long), &arraySize);
-
-	// elementwiseFloatStride
-	err |= clSetKernelArg(elementwiseFS, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(elementwiseFS, 1, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(elementwiseFS, 2, sizeof(cl_mem), &device_fC);
-	err |= clSetKernelArg(elementwiseFS, 4, sizeof(unsigned long), &arraySize);
-
-	// elementwiseDouble
-	err |= clSetKernelArg(elementwiseD, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(elementwiseD, 1, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(elementwiseD, 2, sizeof(cl_mem), &device_dC);
-
-	// elementwiseFloat
-	err |= clSetKernelArg(elementwiseF, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(elementwiseF, 1, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(elementwiseF, 2, sizeof(cl_mem), &device_fC);
-
-	// elementwiseCopyDoubleStride
-	err |= clSetKernelArg(elementwiseCopyDS, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(elementwiseCopyDS, 1, sizeof(cl_mem), &device_dC);
-	err |= clSetKernelArg(elementwiseCopyDS, 3, sizeof(unsigned long), &arraySize);
-
-	// elementwiseCopyFloatStride
-	err |= clSetKernelArg(elementwiseCopyFS, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(elementwiseCopyFS, 1, sizeof(cl_mem), &device_fC);
-	err |= clSetKernelArg(elementwiseCopyFS, 3, sizeof(unsigned long), &arraySize);
-
-	// elementwiseCopyDouble
-	err |= clSetKernelArg(elementwiseCopyD, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(elementwiseCopyD, 1, sizeof(cl_mem), &device_dC);
-
-	// elementwiseCopyFloat
-	err |= clSetKernelArg(elementwiseCopyF, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(elementwiseCopyF, 1, sizeof(cl_mem), &device_fC);
-
-	// copyKernelDouble
-	err |= clSetKernelArg(copyKernelD, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(copyKernelD, 1, sizeof(cl_mem), &device_dC);
-
-	//copyKernelFloat
-	err |= clSetKernelArg(copyKernelF, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(copyKernelF, 1, sizeof(cl_mem), &device_fC);
-
-	// scaleKernelDouble
-	err |= clSetKernelArg(scaleKernelD, 0, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(scaleKernelD, 1, sizeof(cl_mem), &device_dC);
-	err |= clSetKernelArg(scaleKernelD, 2, sizeof(double), &scalarD);
-
-	// scaleKernelFloat
-	err |= clSetKernelArg(scaleKernelF, 0, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(scaleKernelF, 1, sizeof(cl_mem), &device_fC);
-	err |= clSetKernelArg(scaleKernelF, 2, sizeof(float), &scalarF);
-
-	// addKernelDouble
-	err |= clSetKernelArg(addKernelD, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(addKernelD, 1, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(addKernelD, 2, sizeof(cl_mem), &device_dC);
-
-	// addKernelFloat
-	err |= clSetKernelArg(addKernelF, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(addKernelF, 1, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(addKernelF, 2, sizeof(cl_mem), &device_fC);
-
-	// triadKernelDouble
-	err |= clSetKernelArg(triadKernelD, 0, sizeof(cl_mem), &device_dA);
-	err |= clSetKernelArg(triadKernelD, 1, sizeof(cl_mem), &device_dB);
-	err |= clSetKernelArg(triadKernelD, 2, sizeof(cl_mem), &device_dC);
-	err |= clSetKernelArg(triadKernelD, 3, sizeof(double), &scalarD);
-
-	// triadKernelFloat
-	err |= clSetKernelArg(triadKernelF, 0, sizeof(cl_mem), &device_fA);
-	err |= clSetKernelArg(triadKernelF, 1, sizeof(cl_mem), &device_fB);
-	err |= clSetKernelArg(triadKernelF, 2, sizeof(cl_mem), &device_fC);
-	err |= clSetKernelArg(triadKernelF, 3, sizeof(float), &scalarF);
+	printf("\nStart up, %.6lf s to the first kernel\n", startupTime);
+	printf("----------------------------------------------------------------\n");
+	printf("Phase                                   Time (ms)   %% of start up\n");
+	printf("----------------------------------------------------------------\n");
 
-	CheckOpenCLError(err, __LINE__);
+	FILE *csv = fopen(STARTUPFILE, "w");
+	if (csv != NULL)
+		fprintf(csv, "phase,seconds\n");
 
-	// Initialize arrays
-	initializeArays(&queue, &initDoubleArrays, &initFloatArrays, &arraySize);
+	for (int i = 0; i < numStartupPhases; i++)
+	{
+		phasesTime += startupPhases[i].time;
+		printf("%-36s   %10.3lf   %13.2lf\n", startupPhases[i].name, startupPhases[i].time * 1.0e3, 100.0 * startupPhases[i].time / startupTime);
+		if (csv != NULL)
+			fprintf(csv, "%s,%lf\n", startupPhases[i].name, startupPhases[i].time);
+	}
+	printf("%-36s   %10.3lf   %13.2lf\n", "Other", (startupTime - phasesTime) * 1.0e3, 100.0 * (startupTime - phasesTime) / startupTime);
+	printf("----------------------------------------------------------------\n");
 
-	// Fourth argument is the number of memory operations per output array item. Used in bandwidth calculation.
-	// Fifth argument is the number of flops per output array item. Used in flops calculation.
-	// Seventh argument indicates kernel strie idx, and copies the wgsize to the kernel before enqueuing.
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	printf("Function             Best Rate GB/s   Avg time   Min time   Max time   Best Workgroup Size   Best GFLOPS\n");
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &elementwiseDS, 1, "elementwiseDS", 3, 1, arraySize, 3, sizeof(double));
-	RunTest(&queue, &elementwiseFS, 1, "elementwiseFS", 3, 1, arraySize, 3, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &elementwiseD, 1, "elementwiseD", 3, 1, arraySize, -1, sizeof(double));
-	RunTest(&queue, &elementwiseF, 1, "elementwiseF", 3, 1, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &elementwiseCopyDS, 1, "elementwiseCopyDS", 2, 0, arraySize, 2, sizeof(double));
-	RunTest(&queue, &elementwiseCopyFS, 1, "elementwiseCopyFS", 2, 0, arraySize, 2, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &elementwiseCopyD, 1, "elementwiseCopyD", 2, 0, arraySize, -1, sizeof(double));
-	RunTest(&queue, &elementwiseCopyF, 1, "elementwiseCopyF", 2, 0, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &copyKernelD, 1, "copyKernelD", 2, 0, arraySize, -1, sizeof(double));
-	RunTest(&queue, &copyKernelF, 1, "copyKernelF", 2, 0, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &scaleKernelD, 1, "scaleKernelD", 2, 1, arraySize, -1, sizeof(double));
-	RunTest(&queue, &scaleKernelF, 1, "scaleKernelF", 2, 1, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &addKernelD, 1, "addKernelD", 3, 1, arraySize, -1, sizeof(double));
-	RunTest(&queue, &addKernelF, 1, "addKernelF", 3, 1, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
-	RunTest(&queue, &triadKernelD, 1, "triadKernelD", 3, 2, arraySize, -1, sizeof(double));
-	RunTest(&queue, &triadKernelF, 1, "triadKernelF", 3, 2, arraySize, -1, sizeof(float));
-	printf("--------------------------------------------------------------------------------------------------------\n");
+	if (csv != NULL)
+	{
+		fprintf(csv, "Other,%lf\nTotal,%lf\n", startupTime - phasesTime, startupTime);
+		fclose(csv);
+		printf("Start up phases written to %s\n", STARTUPFILE);
+	}
+}
 
-	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
-	return 0;
+// Everything printed or written at the end of the run
+void PrintReports(void)
+{
+	PrintRoofline();
+	PrintStartupProfile();
+#ifdef IDLEANALYSIS
+	PrintIdleAnalysis();
+#endif
+#ifdef TRACE
+	WriteTrace();
+#endif
 }
 
-void RunTest(cl_command_queue *queue, cl_kernel *kernel, size_t vecWidth, char *testName, int memops, int flops, size_t arraySize, int KernelStrideIdx, size_t dataType)
+// Runs the vectorised and multi-element variants of elementwise and elementwiseCopy.
+// Test names are the kernel family, the data type, S when strided, then vN for vloadN/vstoreN
+// (one vector per work-item) or xN for N scalar elements per work-item, e.g. elementwiseDSv4.
+// Buffers are {A, B, C}.
+void RunElementwiseVariantTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffers, cl_mem *floatBuffers, size_t arraySize)
 {
-	size_t localSize;
-	size_t bestLocalSize;
-	size_t globalSize = arraySize;
-	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
-	int err;
+	const char *precisions[] = {"Double", "Float"};
+	const char *typeLetters[] = {"D", "F"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const char *variants[] = {"Vec", "Ilp"};
+	const char *variantLetters[] = {"v", "x"};
+	const size_t widths[] = {2, 4, 8, 16};
+	char kernelName[48];
+	char testName[32];
+	cl_kernel kernel;
+	cl_int err;
 
-	// Test local sizes from 2 to to 256, in powers of 2
-	for (localSize = 16; localSize <= 256; localSize *= 2)
+	// Same order as the scalar tests: elementwise strided and not, then elementwiseCopy strided and not
+	for (int copy = 0; copy < 2; copy++)
 	{
-
-		if (KernelStrideIdx != -1)
+		for (int stride = 1; stride >= 0; stride--)
 		{
-			globalSize = CU * WFP * localSize;
-			err = clSetKernelArg(*kernel, KernelStrideIdx, sizeof(unsigned long), &globalSize);
+			for (int v = 0; v < 2; v++)
+			{
+				for (int w = 0; w < 4; w++)
+				{
+					for (int p = 0; p < 2; p++)
+					{
+						cl_mem *buffers = (p == 0) ? doubleBuffers : floatBuffers;
+						snprintf(kernelName, sizeof(kernelName), "elementwise%s%s%s%s%zu", copy ? "Copy" : "", precisions[p],
+								 stride ? "Stride" : "", variants[v], widths[w]);
+						snprintf(testName, sizeof(testName), "%s%s%s%s%zu", copy ? "elemCopy" : "elementwise", typeLetters[p],
+								 stride ? "S" : "", variantLetters[v], widths[w]);
+
+						kernel = clCreateKernel(*program, kernelName, &err);
+						CheckOpenCLError(err, __LINE__);
+
+						// elementwise reads A and B and writes C, elementwiseCopy reads A and writes C
+						int arg = 0;
+						err = clSetKernelArg(kernel, arg++, sizeof(cl_mem), &buffers[0]);
+						if (!copy)
+						{
+							err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &buffers[1]);
+						}
+						err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &buffers[2]);
+
+						// The stride is set by RunTest. Vec kernels count vectors, Ilp kernels count elements.
+						int strideIdx = -1;
+						if (stride)
+						{
+							cl_ulong vectorLength = (v == 0) ? arraySize / widths[w] : arraySize;
+							strideIdx = arg++;
+							err |= clSetKernelArg(kernel, arg++, sizeof(cl_ulong), &vectorLength);
+						}
+						CheckOpenCLError(err, __LINE__);
+
+						RunTest(queue, &kernel, widths[w], testName, copy ? 2 : 3, copy ? 0 : 1, arraySize, strideIdx, typeSizes[p]);
+						clReleaseKernel(kernel);
+					}
+				}
+			}
+			printf("--------------------------------------------------------------------------------------------------------\n");
 		}
+	}
+}
 
-		if (globalSize % localSize != 0)
-		{
-			printf("Error, localSize must divide globalSize! (%zu %% %zu = %zu)\n",
-			globalSize, localSize, globalSize % localSize);
-		}
+void RunPeakFlopsTests(cl_program *program, cl_command_queue *queue, cl_mem *doubleBuffer, cl_mem *floatBuffer, size_t arraySize)
+{
+	const char *precisions[] = {"Double", "Float", "Half"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float), sizeof(cl_half)};
+	const char *operations[] = {"Mad", "Fma", "MulAdd"};
+	const size_t vecWidths[] = {1, 2, 4, 8, 16};
+	char kernelName[32];
+	cl_kernel kernel;
+	cl_int err;
 
-		double time = GetWallTime();
+	// Each array element gets PEAK_ITERS iterations of PEAK_CHAINS multiply-adds (2 flops)
+	int flopsPerItem = PEAK_ITERS * PEAK_CHAINS * 2;
 
-		for (int n = 0; n < NTIMES; n++)
+	for (int p = 0; p < 3; p++)
+	{
+		// Half kernels are only compiled in when the device has cl_khr_fp16
+		if (typeSizes[p] == sizeof(cl_half) && !DeviceSupportsExtension(queue, "cl_khr_fp16"))
 		{
-			err = clEnqueueNDRangeKernel(*queue, *kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+			printf("Device does not support cl_khr_fp16, skipping half precision peak tests\n");
+			continue;
 		}
-		clFinish(*queue);
-		CheckOpenCLError(err, __LINE__);
 
-		time = GetWallTime() - time;
-		if (time < bestTime)
-		{
-			bestTime = time;
-			bestLocalSize = localSize;
-		}
-		if (time > worstTime)
+		for (int o = 0; o < 3; o++)
 		{
-			worstTime = time;
+			for (int w = 0; w < 5; w++)
+			{
+				snprintf(kernelName, sizeof(kernelName), "peak%s%s%zu", operations[o], precisions[p], vecWidths[w]);
+				kernel = clCreateKernel(*program, kernelName, &err);
+				CheckOpenCLError(err, __LINE__);
+
+				// Only one value per work-item is written, so the output always fits in the array
+				err = clSetKernelArg(kernel, 0, sizeof(cl_mem), typeSizes[p] == sizeof(cl_double) ? doubleBuffer : floatBuffer);
+				CheckOpenCLError(err, __LINE__);
+
+				RunTest(queue, &kernel, vecWidths[w], kernelName, 1, flopsPerItem, arraySize, -1, typeSizes[p]);
+				clReleaseKernel(kernel);
+			}
 		}
-		totalTime += time;
+		printf("--------------------------------------------------------------------------------------------------------\n");
+	}
+}
 
-#ifdef VERBOSE
-		printf("------------- localSize = %3zu, bandwidth = %7.3lf GB/s\n",
-			   localSize, memops * NTIMES * arraySize * sizeof(float) / 1024.0 / 1024.0 / 1024.0 / (time));
-#endif
+void RunIntensitySweep(cl_context *context, cl_command_queue *queue, cl_mem *doubleIn, cl_mem *doubleOut, cl_mem *floatIn, cl_mem *floatOut, size_t arraySize)
+{
+	cl_device_id device;
+	cl_program sweepProgram;
+	cl_kernel sweepD, sweepF;
+	char options[128];
+	char testName[32];
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+
+	for (int sweepFlops = 2; sweepFlops <= MAXSWEEPFLOPS; sweepFlops *= 2)
+	{
+		// The flops per element are fixed at build time, so the loop is fully unrolled
+		snprintf(options, sizeof(options), "-I. -DPEAK_ITERS=%d -DSWEEP_FLOPS=%d", PEAK_ITERS, sweepFlops);
+		sweepProgram = BuildProgram(*context, device, options);
+		if (sweepProgram == NULL)
+			return;
+
+		sweepD = clCreateKernel(sweepProgram, "intensitySweepDouble", &err);
+		sweepF = clCreateKernel(sweepProgram, "intensitySweepFloat", &err);
+		CheckOpenCLError(err, __LINE__);
+
+		err = clSetKernelArg(sweepD, 0, sizeof(cl_mem), doubleIn);
+		err |= clSetKernelArg(sweepD, 1, sizeof(cl_mem), doubleOut);
+		err |= clSetKernelArg(sweepF, 0, sizeof(cl_mem), floatIn);
+		err |= clSetKernelArg(sweepF, 1, sizeof(cl_mem), floatOut);
+		CheckOpenCLError(err, __LINE__);
+
+		snprintf(testName, sizeof(testName), "sweepD%d", sweepFlops);
+		RunTest(queue, &sweepD, 1, testName, 2, sweepFlops, arraySize, -1, sizeof(double));
+		snprintf(testName, sizeof(testName), "sweepF%d", sweepFlops);
+		RunTest(queue, &sweepF, 1, testName, 2, sweepFlops, arraySize, -1, sizeof(float));
+
+		clReleaseKernel(sweepD);
+		clReleaseKernel(sweepF);
+		clReleaseProgram(sweepProgram);
 	}
+	printf("--------------------------------------------------------------------------------------------------------\n");
+}
 
-	printf("%18s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %19zu   %11.3lf\n",
-		   testName, memops * NTIMES * arraySize * dataType / 1024.0 / 1024.0 / 1024.0 / bestTime, totalTime / NTIMES,
-		   bestTime, worstTime, bestLocalSize, flops * NTIMES * arraySize / 1.0e9 / bestTime);
+// Builds the roofline from the results of all the tests run so far.
+// Peak bandwidth is the best GB/s of any test, peak FLOPS is the best GFLOPS of any
+// test of the same precision. Bandwidth is in GB/s (1024^3) like the rest of the tables.
+void PrintRoofline(void)
+{
+	const char *precisions[] = {"double", "float", "half"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float), sizeof(cl_half)};
+	double peakBandwidth = 0.0;
+	double peakGflops[3] = {0.0, 0.0, 0.0};
+	double ridgePoint[3] = {0.0, 0.0, 0.0};
+
+	for (int i = 0; i < numResults; i++)
+	{
+		if (results[i].bandwidth > peakBandwidth)
+			peakBandwidth = results[i].bandwidth;
+
+		for (int p = 0; p < 3; p++)
+			if (results[i].dataType == typeSizes[p] && results[i].gflops > peakGflops[p])
+				peakGflops[p] = results[i].gflops;
+	}
+
+	// Ridge point: flops per byte needed to move from memory bound to compute bound
+	double peakBytes = peakBandwidth * 1024.0 * 1024.0 * 1024.0;
+	for (int p = 0; p < 3; p++)
+		ridgePoint[p] = peakBytes > 0.0 ? peakGflops[p] * 1.0e9 / peakBytes : 0.0;
+
+	printf("\nRoofline\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Peak bandwidth       %14.3lf GB/s\n", peakBandwidth);
+	for (int p = 0; p < 3; p++)
+	{
+		if (peakGflops[p] > 0.0)
+			printf("Peak %-6s           %14.3lf GFLOPS   Ridge point %8.3lf flops/byte\n", precisions[p], peakGflops[p], ridgePoint[p]);
+	}
+	printf("--------------------------------------------------------------------------------------------------------\n");
+	printf("Function             Intensity (flops/byte)   Attained GFLOPS   Roof GFLOPS   %% of roof   Bound\n");
+	printf("--------------------------------------------------------------------------------------------------------\n");
+
+	FILE *csv = fopen(ROOFLINEFILE, "w");
+	if (csv != NULL)
+		fprintf(csv, "function,precision,intensity,gflops,bandwidth,roof_gflops,peak_bandwidth,peak_gflops\n");
+
+	for (int i = 0; i < numResults; i++)
+	{
+		int p = 0;
+		while (p < 2 && results[i].dataType != typeSizes[p])
+			p++;
+
+		// The attainable performance is the lower of the two roofs
+		double memoryRoof = results[i].intensity * peakBytes / 1.0e9;
+		double roof = memoryRoof < peakGflops[p] ? memoryRoof : peakGflops[p];
+		double ofRoof = roof > 0.0 ? 100.0 * results[i].gflops / roof : 0.0;
+
+		printf("%18s   %22.3lf   %15.3lf   %11.3lf   %9.2lf   %s\n",
+			   results[i].name, results[i].intensity, results[i].gflops, roof, ofRoof,
+			   results[i].intensity < ridgePoint[p] ? "memory" : "compute");
+
+		if (csv != NULL)
+			fprintf(csv, "%s,%s,%lf,%lf,%lf,%lf,%lf,%lf\n", results[i].name, precisions[p], results[i].intensity,
+					results[i].gflops, results[i].bandwidth, roof, peakBandwidth, peakGflops[p]);
+	}
+	printf("--------------------------------------------------------------------------------------------------------\n");
+
+	if (csv != NULL)
+	{
+		fclose(csv);
+		printf("Roofline written to %s\n", ROOFLINEFILE);
+	}
 }
 
-void initializeArays(cl_command_queue *queue, cl_kernel *initDoublesKernel, cl_kernel *initFloatsKernel, size_t *arraySize)
+// Sets A, B and C to 1, 2 and 0 with the init kernel of the type, or with clEnqueueFillBuffer when there is none
+// (a registry source file doesn't have the init kernels)
+void initializeArays(cl_command_queue *queue, cl_kernel *initKernel, cl_mem *buffers, size_t arraySize, size_t dataType)
 {
 	size_t initLocalSize = 64;
-	size_t initGlobalSize = *arraySize;
-	int err;
+	size_t initGlobalSize = arraySize;
+	int err = CL_SUCCESS;
 
-	err = clEnqueueNDRangeKernel(*queue, *initDoublesKernel, 1, NULL, &initGlobalSize, &initLocalSize, 0, NULL, NULL);
-	err = clEnqueueNDRangeKernel(*queue, *initFloatsKernel, 1, NULL, &initGlobalSize, &initLocalSize, 0, NULL, NULL);
+	if (*initKernel != NULL)
+	{
+		err = clEnqueueNDRangeKernel(*queue, *initKernel, 1, NULL, &initGlobalSize, &initLocalSize, 0, NULL, NULL);
+	}
+	else
+	{
+		const cl_double valuesD[3] = {1.0, 2.0, 0.0};
+		const cl_float valuesF[3] = {1.0f, 2.0f, 0.0f};
+		size_t patternSize = dataType == sizeof(cl_double) ? sizeof(cl_double) : sizeof(cl_float);
+		for (int i = 0; i < 3; i++)
+		{
+			err |= clEnqueueFillBuffer(*queue, buffers[i], patternSize == sizeof(cl_double) ? (const void *)&valuesD[i] : (const void *)&valuesF[i],
+									   patternSize, 0, arraySize * patternSize, 0, NULL, NULL);
+		}
+	}
 	clFinish(*queue);
 
 	CheckOpenCLError(err, __LINE__);
@@ -358,26 +2387,138 @@ double GetWallTime(void)
 	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
 }
 
-void SanitizeAndRoundArraySize(size_t *sizeBytes, cl_ulong maxAlloc, cl_ulong globalMemSize, size_t typeSize, size_t *arraySize, char *arrayName)
+// Largest array size up to arraySize, a multiple of 256 (the largest local size), for which numArrays arrays of
+// typeSize elements and reservedBytes more take at most ARENAFRACTION of the global memory and each array fits in a single allocation
+size_t FitArraySize(size_t arraySize, int numArrays, size_t typeSize, size_t reservedBytes, cl_ulong maxAlloc, cl_ulong globalMemSize)
+{
+	size_t fitted = arraySize;
+
+	if (fitted * typeSize > maxAlloc)
+	{
+		fitted = (size_t)(maxAlloc / typeSize);
+	}
+
+	if ((double)numArrays * fitted * typeSize + reservedBytes > ARENAFRACTION * globalMemSize)
+	{
+		double available = ARENAFRACTION * globalMemSize - reservedBytes;
+		fitted = available > 0.0 ? (size_t)(available / numArrays / typeSize) : 0;
+	}
+
+	// round down to multiple of 256
+	fitted = (fitted / 256) * 256;
+
+	if (fitted != arraySize)
+	{
+		printf("Adjusting array size from %zu to %zu elements (%zuMB to %zuMB)\n", arraySize, fitted, arraySize * typeSize / 1024 / 1024, fitted * typeSize / 1024 / 1024);
+	}
+	return fitted;
+}
+
+// Allocates the arena, numSlots slots of slotBytes rounded up to the base address alignment, in as few blocks as
+// CL_DEVICE_MAX_MEM_ALLOC_SIZE allows, and a scratch block of scratchBytes when it isn't 0. Returns 0 if it doesn't fit.
+int ArenaCreate(Arena *arena, cl_context context, cl_device_id device, int numSlots, size_t slotBytes, size_t scratchBytes)
+{
+	cl_uint baseAlignBits;
+	cl_ulong maxAlloc;
+	cl_int err;
+
+	err = clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(baseAlignBits), &baseAlignBits, NULL);
+	err |= clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+	CheckOpenCLError(err, __LINE__);
+
+	size_t baseAlign = baseAlignBits / 8;
+	memset(arena, 0, sizeof(*arena));
+	arena->numSlots = numSlots;
+	arena->slotBytes = ((slotBytes + baseAlign - 1) / baseAlign) * baseAlign;
+	arena->slotsPerBlock = (int)(maxAlloc / arena->slotBytes);
+	if (arena->slotsPerBlock == 0)
+	{
+		return 0;
+	}
+	if (arena->slotsPerBlock > numSlots)
+	{
+		arena->slotsPerBlock = numSlots;
+	}
+	arena->numBlocks = (numSlots + arena->slotsPerBlock - 1) / arena->slotsPerBlock;
+	if (arena->numBlocks > MAXARENABLOCKS)
+	{
+		return 0;
+	}
+
+	double time = GetWallTime();
+	for (int b = 0; b < arena->numBlocks; b++)
+	{
+		int slots = numSlots - b * arena->slotsPerBlock;
+		if (slots > arena->slotsPerBlock)
+		{
+			slots = arena->slotsPerBlock;
+		}
+		arena->blockBytes[b] = slots * arena->slotBytes;
+		arena->blocks[b] = clCreateBuffer(context, CL_MEM_READ_WRITE, arena->blockBytes[b], NULL, &err);
+		if (err != CL_SUCCESS)
+		{
+			arena->numBlocks = b;
+			ArenaRelease(arena);
+			return 0;
+		}
+	}
+	if (scratchBytes > 0)
+	{
+		arena->scratchBytes = scratchBytes;
+		arena->scratch = clCreateBuffer(context, CL_MEM_READ_WRITE, scratchBytes, NULL, &err);
+		if (err != CL_SUCCESS)
+		{
+			arena->scratch = NULL;
+			ArenaRelease(arena);
+			return 0;
+		}
+	}
+	arena->createTime = GetWallTime() - time;
+
+	return 1;
+}
+
+// Creates numViews sub-buffers of viewBytes, one per slot from the first. Views of the same slot share the memory.
+int ArenaViews(Arena *arena, int numViews, size_t viewBytes, cl_mem *views)
 {
-	if (*sizeBytes > maxAlloc)
+	cl_buffer_region region;
+	cl_int err;
+
+	if (numViews > arena->numSlots || viewBytes > arena->slotBytes || arena->numViews + numViews > MAXARENAVIEWS)
 	{
-		*sizeBytes = (size_t)maxAlloc;
+		return 0;
 	}
 
-	while (3 * (*sizeBytes) > globalMemSize)
+	for (int i = 0; i < numViews; i++)
 	{
-		printf("Adjusting array size of %s from %zuMB to %zuMB\n", arrayName, *sizeBytes, (*sizeBytes) / 2);
-		(*sizeBytes) /= 2;
+		region.origin = (i % arena->slotsPerBlock) * arena->slotBytes;
+		region.size = viewBytes;
+		views[i] = clCreateSubBuffer(arena->blocks[i / arena->slotsPerBlock], CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+		CheckOpenCLError(err, __LINE__);
+		arena->views[arena->numViews++] = views[i];
 	}
 
-	// After sanitizing, we must ensure the new arrray size is a multiple of 256, the largest local workgroup size
-	if (((*sizeBytes) / typeSize) % 256 != 0)
+	return 1;
+}
+
+// Releases the views, then the blocks
+void ArenaRelease(Arena *arena)
+{
+	for (int i = 0; i < arena->numViews; i++)
 	{
-		// round down to multiple of 256
-		printf("Adjusting array size from %zuMB to %zuMB\n", (*arraySize) * typeSize, (((*arraySize) / 256) * 256) * typeSize);
-		(*sizeBytes) = (((*arraySize) / 256) * 256) * typeSize;
+		clReleaseMemObject(arena->views[i]);
 	}
+	for (int b = 0; b < arena->numBlocks; b++)
+	{
+		clReleaseMemObject(arena->blocks[b]);
+	}
+	if (arena->scratch != NULL)
+	{
+		clReleaseMemObject(arena->scratch);
+	}
+	arena->numViews = 0;
+	arena->numBlocks = 0;
+	arena->scratch = NULL;
 }
 
 // OpenCL functions
@@ -387,30 +2528,23 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 	cl_int err;
 	char infostring[1024];
 
-	// get kernel from file
-	FILE *kernelFile = fopen(kernelFileName, "rb");
-	fseek(kernelFile, 0, SEEK_END);
-	long fileLength = ftell(kernelFile);
-	rewind(kernelFile);
-	char *kernelSource = malloc(fileLength * sizeof(char));
-	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
-	if (fileLength != read)
-		printf("Error reading kernel file, line %d\n", __LINE__);
-	fclose(kernelFile);
-
 	// get platform and device information
 	cl_uint numPlatforms;
+	char phaseName[48];
+	double phaseStart = GetWallTime();
 	err = clGetPlatformIDs(0, NULL, &numPlatforms);
 	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
 	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
 	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
 	CheckOpenCLError(err, __LINE__);
+	AddStartupPhase("clGetPlatformIDs", phaseStart, GetWallTime());
 	cl_uint *numDevices;
 	numDevices = calloc(numPlatforms, sizeof(cl_uint));
 
 	// Retrieves information about the platform, and for each platform, about the devices.
 	for (cl_uint i = 0; i < numPlatforms; i++)
 	{
+		phaseStart = GetWallTime();
 		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
 		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
 
@@ -421,9 +2555,12 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
 		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
 		CheckOpenCLError(err, __LINE__);
+		snprintf(phaseName, sizeof(phaseName), "clGetDeviceIDs platform %u", i);
+		AddStartupPhase(phaseName, phaseStart, GetWallTime());
 		for (cl_uint j = 0; j < numDevices[i]; j++)
 		{
 			char deviceName[200];
+			phaseStart = GetWallTime();
 			cl_device_fp_config doublePrecisionSupport = 0;
 
 			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
@@ -444,6 +2581,8 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
 			if (doublePrecisionSupport == 0)
 				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+			snprintf(phaseName, sizeof(phaseName), "clGetDeviceInfo device %u.%u", i, j);
+			AddStartupPhase(phaseName, phaseStart, GetWallTime());
 		}
 	}
 
@@ -502,44 +2641,264 @@ int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id
 	printf("\n");
 
 	// store global mem size and max allocation size
+	phaseStart = GetWallTime();
 	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
 	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+	AddStartupPhase("clGetDeviceInfo memory sizes", phaseStart, GetWallTime());
 
 	// create a context
+	phaseStart = GetWallTime();
 	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
 	CheckOpenCLError(err, __LINE__);
-	// create a queue
-	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	AddStartupPhase("clCreateContext", phaseStart, GetWallTime());
+	// create a queue, the trace and the idle analysis need the profiling timestamps
+	cl_command_queue_properties queueProperties = 0;
+#if defined(TRACE) || defined(IDLEANALYSIS)
+	queueProperties = CL_QUEUE_PROFILING_ENABLE;
+#endif
+	phaseStart = GetWallTime();
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], queueProperties, &err);
 	CheckOpenCLError(err, __LINE__);
+	AddStartupPhase("clCreateCommandQueue", phaseStart, GetWallTime());
+
+	// create and build the program, the host defines the parameters of the peak kernels
+	// -cl-kernel-arg-info lets the registry bind the kernel arguments
+	char buildOptions[512];
+	snprintf(buildOptions, sizeof(buildOptions), "-I. -cl-kernel-arg-info -DPEAK_ITERS=%d %s", PEAK_ITERS, registryOptions);
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], buildOptions);
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	double phaseStart = GetWallTime();
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+	AddStartupPhase("Kernel file read", phaseStart, GetWallTime());
 
 	// create the program with the source above
 #ifdef VERBOSE
 	printf("Creating CL Program...\n");
 #endif
-	*program = clCreateProgramWithSource(*context, 1, (const char **)&kernelSource, NULL, &err);
+	phaseStart = GetWallTime();
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	AddStartupPhase("clCreateProgramWithSource", phaseStart, GetWallTime());
 	if (err != CL_SUCCESS)
 	{
 		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
-		return EXIT_FAILURE;
+		return NULL;
 	}
 
 	// build program executable
 #ifdef VERBOSE
-	printf("Building CL Executable...\n");
+	printf("Building CL Executable (%s)...\n", options);
 #endif
-	err = clBuildProgram(*program, 0, NULL, "-I.", NULL, NULL);
+	char fullOptions[640];
+	snprintf(fullOptions, sizeof(fullOptions), "%s%s", options, ResourceUsageBuildOptions(device));
+	phaseStart = GetWallTime();
+	err = clBuildProgram(program, 1, &device, fullOptions, NULL, NULL);
+
+	// Some drivers reject the resource usage options, try again without them
+	if (err != CL_SUCCESS && strcmp(fullOptions, options) != 0)
+		err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+	AddStartupPhase("clBuildProgram", phaseStart, GetWallTime());
+
 	if (err != CL_SUCCESS)
 	{
 		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
 		char buffer[5000];
-		clGetProgramBuildInfo(*program, (*device_id)[chosenPlatform][chosenDevice], CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
 		printf("%s\n", buffer);
-		return EXIT_FAILURE;
+		clReleaseProgram(program);
+		return NULL;
 	}
 
-	free(numDevices);
-	free(kernelSource);
-	return EXIT_SUCCESS;
+#ifdef RESOURCEREPORT
+	phaseStart = GetWallTime();
+	ParseBuildLog(program, device);
+	AddStartupPhase("ParseBuildLog", phaseStart, GetWallTime());
+#endif
+	return program;
+}
+
+// Vendor build options that make the compiler write register usage to the build log
+const char *ResourceUsageBuildOptions(cl_device_id device)
+{
+#ifdef RESOURCEREPORT
+	char vendor[256];
+	clGetDeviceInfo(device, CL_DEVICE_VENDOR, sizeof(vendor), vendor, NULL);
+	if (strstr(vendor, "Advanced Micro Devices") != NULL || strstr(vendor, "AMD") != NULL)
+		return " -Rpass-analysis=kernel-resource-usage";
+	if (strstr(vendor, "NVIDIA") != NULL)
+		return " -cl-nv-verbose";
+#endif
+	return "";
+}
+
+// Returns the resources entry of the kernel, adding it if it's not there yet.
+// The name ends at the first space, quote or bracket, as it comes from the build log.
+KernelResources *AddKernelResources(const char *name)
+{
+	char kernelName[64];
+	int length = 0;
+	while (name[length] != '\0' && name[length] != ' ' && name[length] != '\'' && name[length] != '[' && length < 63)
+	{
+		kernelName[length] = name[length];
+		length++;
+	}
+	kernelName[length] = '\0';
+
+	for (int i = 0; i < numKernelResources; i++)
+		if (strcmp(kernelResources[i].name, kernelName) == 0)
+			return &kernelResources[i];
+
+	if (numKernelResources == MAXKERNELS)
+		return NULL;
+
+	KernelResources *resources = &kernelResources[numKernelResources++];
+	snprintf(resources->name, sizeof(resources->name), "%s", kernelName);
+	resources->registers = -1;
+	resources->spills = -1;
+	resources->wavesPerSIMD = -1;
+	return resources;
+}
+
+// Reads registers, spills and occupancy from the build log. AMD prints them as remarks:
+//   remark: kernels.cl:1:0: Function Name: copyKernelDouble [-Rpass-analysis=kernel-resource-usage]
+//   remark: kernels.cl:1:0:     VGPRs: 4 [...]  /  VGPRs Spill: 0 [...]  /  Occupancy [waves/SIMD]: 10 [...]
+// NVIDIA prints the ptxas info:
+//   ptxas info    : Function properties for copyKernelDouble
+//       0 bytes stack frame, 0 bytes spill stores, 0 bytes spill loads
+//   ptxas info    : Used 8 registers, 368 bytes cmem[0]
+void ParseBuildLog(cl_program program, cl_device_id device)
+{
+	size_t logSize;
+	KernelResources *current = NULL;
+	char *field;
+
+	clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &logSize);
+	char *buildLog = malloc(logSize + 1);
+	clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, logSize, buildLog, NULL);
+	buildLog[logSize] = '\0';
+
+	for (char *line = strtok(buildLog, "\n"); line != NULL; line = strtok(NULL, "\n"))
+	{
+		if ((field = strstr(line, "Function Name: ")) != NULL)
+			current = AddKernelResources(field + strlen("Function Name: "));
+		else if ((field = strstr(line, "Function properties for ")) != NULL)
+			current = AddKernelResources(field + strlen("Function properties for "));
+		else if (current == NULL)
+			continue;
+		else if ((field = strstr(line, "VGPRs: ")) != NULL)
+			current->registers = atoi(field + strlen("VGPRs: "));
+		else if ((field = strstr(line, "VGPRs Spill: ")) != NULL)
+			current->spills = atoi(field + strlen("VGPRs Spill: "));
+		else if ((field = strstr(line, "Occupancy [waves/SIMD]: ")) != NULL)
+			current->wavesPerSIMD = atoi(field + strlen("Occupancy [waves/SIMD]: "));
+		else if ((field = strstr(line, "bytes spill stores")) != NULL)
+			sscanf(line, " %*d bytes stack frame, %d bytes spill stores", &current->spills);
+		else if ((field = strstr(line, "Used ")) != NULL && strstr(line, "registers") != NULL)
+			current->registers = atoi(field + strlen("Used "));
+	}
+
+	free(buildLog);
+}
+
+// Estimated occupancy, as the % of the lanes of the WFP wavefront slots of a CU that are kept busy
+// by work-groups of localSize. Work-groups are limited by the wavefront slots, the local memory,
+// and the waves per SIMD the compiler allows (when known).
+double EstimateOccupancy(size_t localSize, size_t maxWorkGroupSize, size_t wavefrontSize, cl_ulong kernelLocalMem, cl_ulong deviceLocalMem, int wavesPerSIMD)
+{
+	if (localSize > maxWorkGroupSize || wavefrontSize == 0)
+		return 0.0;
+
+	size_t wavesPerGroup = (localSize + wavefrontSize - 1) / wavefrontSize;
+	size_t maxWaves = WFP;
+	if (wavesPerSIMD > 0 && (size_t)wavesPerSIMD * SIMD < maxWaves)
+		maxWaves = wavesPerSIMD * SIMD;
+
+	size_t groups = maxWaves / wavesPerGroup;
+	if (kernelLocalMem > 0 && deviceLocalMem / kernelLocalMem < groups)
+		groups = deviceLocalMem / kernelLocalMem;
+
+	return 100.0 * groups * localSize / (WFP * wavefrontSize);
+}
+
+// Prints the resources of the kernel and its occupancy for every tested local size, ending the line
+void PrintKernelResources(cl_command_queue *queue, cl_kernel *kernel)
+{
+	cl_device_id device;
+	char kernelName[64];
+	size_t maxWorkGroupSize, wavefrontSize;
+	cl_ulong privateMem, localMem, deviceLocalMem;
+	char registers[16] = "-", spills[16] = "-";
+	int wavesPerSIMD = -1;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(deviceLocalMem), &deviceLocalMem, NULL);
+	clGetKernelInfo(*kernel, CL_KERNEL_FUNCTION_NAME, sizeof(kernelName), kernelName, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(wavefrontSize), &wavefrontSize, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(privateMem), &privateMem, NULL);
+	clGetKernelWorkGroupInfo(*kernel, device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof(localMem), &localMem, NULL);
+
+	for (int i = 0; i < numKernelResources; i++)
+	{
+		if (strcmp(kernelResources[i].name, kernelName) != 0)
+			continue;
+		if (kernelResources[i].registers >= 0)
+			snprintf(registers, sizeof(registers), "%d", kernelResources[i].registers);
+		if (kernelResources[i].spills >= 0)
+			snprintf(spills, sizeof(spills), "%d", kernelResources[i].spills);
+		wavesPerSIMD = kernelResources[i].wavesPerSIMD;
+	}
+
+	printf("   %4s   %6s   %7lu   %5lu   %5zu   ", registers, spills, privateMem, localMem, maxWorkGroupSize);
+	for (size_t localSize = 16; localSize <= 256; localSize *= 2)
+	{
+		printf("%s%3.0lf", localSize == 16 ? "" : "/",
+			   EstimateOccupancy(localSize, maxWorkGroupSize, wavefrontSize, localMem, deviceLocalMem, wavesPerSIMD));
+	}
+	printf("\n");
+}
+
+// Returns 1 if the device behind the queue reports the extension, 0 otherwise
+int DeviceSupportsExtension(cl_command_queue *queue, const char *extension)
+{
+	cl_device_id device;
+	size_t extensionsSize;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, 0, NULL, &extensionsSize);
+	char *extensions = malloc(extensionsSize);
+	clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, extensionsSize, extensions, NULL);
+
+	int supported = strstr(extensions, extension) != NULL;
+	free(extensions);
+	return supported;
 }
 
 void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
@@ -0,0 +1,13 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Copy kernel, same as copyKernel1 of the stream-double benchmark. Every host thread has its own A and C.
+__kernel void copyKernel1(__global const double * restrict A,
+                          __global double * restrict C)
+{
+	size_t tid = get_global_id(0);
+
+	C[tid] = A[tid];
+}
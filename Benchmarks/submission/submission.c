@@ -0,0 +1,658 @@
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels
+const char *kernelFileName = "kernels.cl";
+
+// Host threads from 1 up to MAXTHREADS (powers of 2), each pinned to a core
+#define MAXTHREADS 16
+
+// Commands enqueued by every thread. Every TRANSFEREVERY-th is a non-blocking write of TRANSFERSIZE doubles, the rest
+// are copyKernel1 launches on LAUNCHSIZE doubles.
+#define COMMANDSPERTHREAD 2000
+#define TRANSFEREVERY 4
+#define TRANSFERSIZE 4096
+#define LAUNCHSIZE 4096
+
+// Work-items per work-group
+#define LOCALSIZE 256
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-thread results during test?
+// #define VERBOSE
+
+// State of one submitting thread. Every thread has its own kernel, clSetKernelArg isn't thread safe on a shared one.
+typedef struct
+{
+	int id;
+	cl_command_queue queue;
+	cl_kernel kernel;
+	cl_mem A, C;
+	double *hostData;
+	double *latencies; // Time spent in every enqueue call, COMMANDSPERTHREAD
+	pthread_barrier_t *start;
+	cl_int err;
+} SubmitThread;
+
+// Function prototypes
+double GetWallTime(void);
+int CompareDoubles(const void *a, const void *b);
+void *SubmitThreadMain(void *arg);
+void RunSubmissionTests(cl_context *context, cl_command_queue *queue, cl_program *program);
+double RunSubmissionTest(cl_context *context, cl_device_id device, SubmitThread *threads, int numThreads, int sharedQueue, double *latencies);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(void)
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+
+	RunSubmissionTests(&context, &queue, &program);
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+int CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// Pins itself to a core, waits for every other thread and enqueues its commands, timing every enqueue call
+void *SubmitThreadMain(void *arg)
+{
+	SubmitThread *thread = arg;
+	size_t globalSize = LAUNCHSIZE;
+	size_t localSize = LOCALSIZE;
+	cpu_set_t cpus;
+
+	CPU_ZERO(&cpus);
+	CPU_SET(thread->id % sysconf(_SC_NPROCESSORS_ONLN), &cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+	thread->err = clSetKernelArg(thread->kernel, 0, sizeof(cl_mem), &thread->A);
+	thread->err |= clSetKernelArg(thread->kernel, 1, sizeof(cl_mem), &thread->C);
+	pthread_barrier_wait(thread->start);
+
+	for (int c = 0; c < COMMANDSPERTHREAD; c++)
+	{
+		double time = GetWallTime();
+		if (c % TRANSFEREVERY == TRANSFEREVERY - 1)
+			thread->err |= clEnqueueWriteBuffer(thread->queue, thread->A, CL_FALSE, 0, TRANSFERSIZE * sizeof(cl_double), thread->hostData, 0, NULL, NULL);
+		else
+			thread->err |= clEnqueueNDRangeKernel(thread->queue, thread->kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+		thread->latencies[c] = GetWallTime() - time;
+	}
+	clFlush(thread->queue);
+	return NULL;
+}
+
+// Runs 1 to MAXTHREADS submitting threads, all into one shared queue and each into its own queue (same context)
+void RunSubmissionTests(cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	cl_device_id device;
+	SubmitThread threads[MAXTHREADS];
+	double singleLatency[2] = {0.0, 0.0};
+	double *latencies = malloc((size_t)MAXTHREADS * COMMANDSPERTHREAD * sizeof(double));
+	cl_int err;
+
+	clGetCommandQueueInfo(*queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+
+	for (int t = 0; t < MAXTHREADS; t++)
+	{
+		threads[t].id = t;
+		threads[t].kernel = clCreateKernel(*program, "copyKernel1", &err);
+		threads[t].A = clCreateBuffer(*context, CL_MEM_READ_WRITE, LAUNCHSIZE * sizeof(cl_double), NULL, &err);
+		threads[t].C = clCreateBuffer(*context, CL_MEM_READ_WRITE, LAUNCHSIZE * sizeof(cl_double), NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+		threads[t].hostData = malloc(TRANSFERSIZE * sizeof(cl_double));
+		for (int i = 0; i < TRANSFERSIZE; i++)
+			threads[t].hostData[i] = 1.0;
+		threads[t].latencies = latencies + (size_t)t * COMMANDSPERTHREAD;
+	}
+
+	// Latencies are per enqueue call, in microseconds. "p50 vs 1" is how much slower the median enqueue is than with a single
+	// thread on the same kind of queue, the cost of contention in the runtime.
+	printf("Host cores: %ld, commands per thread: %d (1 in %d a %d doubles write, the rest %d doubles launches)\n",
+		   sysconf(_SC_NPROCESSORS_ONLN), COMMANDSPERTHREAD, TRANSFEREVERY, TRANSFERSIZE, LAUNCHSIZE);
+	printf("---------------------------------------------------------------------------------------------------------\n");
+	printf("Threads   Queues          Commands/s   Launches/s   p50 (us)   p90 (us)   p99 (us)   Max (us)   p50 vs 1\n");
+	printf("---------------------------------------------------------------------------------------------------------\n");
+
+	for (int sharedQueue = 1; sharedQueue >= 0; sharedQueue--)
+	{
+		for (int numThreads = 1; numThreads <= MAXTHREADS; numThreads *= 2)
+		{
+			size_t samples = (size_t)numThreads * COMMANDSPERTHREAD;
+
+			// First run is a warm up
+			RunSubmissionTest(context, device, threads, numThreads, sharedQueue, latencies);
+			double time = RunSubmissionTest(context, device, threads, numThreads, sharedQueue, latencies);
+
+			qsort(latencies, samples, sizeof(double), CompareDoubles);
+			double p50 = latencies[samples / 2] * 1.0e6;
+			double p90 = latencies[samples * 9 / 10] * 1.0e6;
+			double p99 = latencies[samples * 99 / 100] * 1.0e6;
+			double max = latencies[samples - 1] * 1.0e6;
+			if (numThreads == 1)
+				singleLatency[sharedQueue] = p50;
+
+			size_t launches = samples - (size_t)numThreads * (COMMANDSPERTHREAD / TRANSFEREVERY);
+			printf("%7d   %-12s %12.0lf %12.0lf   %8.2lf   %8.2lf   %8.2lf   %8.2lf   %8.2lf\n",
+				   numThreads, sharedQueue ? "shared" : "per-thread", samples / time, launches / time, p50, p90, p99, max, p50 / singleLatency[sharedQueue]);
+		}
+		printf("---------------------------------------------------------------------------------------------------------\n");
+	}
+
+	for (int t = 0; t < MAXTHREADS; t++)
+	{
+		clReleaseKernel(threads[t].kernel);
+		clReleaseMemObject(threads[t].A);
+		clReleaseMemObject(threads[t].C);
+		free(threads[t].hostData);
+	}
+	free(latencies);
+}
+
+// Starts numThreads threads at once and waits for them and for their commands to finish. Returns the wall time from
+// the start to the end of the last command. The latencies of all the threads are left in latencies.
+double RunSubmissionTest(cl_context *context, cl_device_id device, SubmitThread *threads, int numThreads, int sharedQueue, double *latencies)
+{
+	pthread_t handles[MAXTHREADS];
+	pthread_barrier_t start;
+	cl_command_queue queues[MAXTHREADS];
+	int numQueues = sharedQueue ? 1 : numThreads;
+	cl_int err;
+
+	for (int q = 0; q < numQueues; q++)
+	{
+		queues[q] = clCreateCommandQueue(*context, device, 0, &err);
+		CheckOpenCLError(err, __LINE__);
+	}
+
+	pthread_barrier_init(&start, NULL, numThreads + 1);
+	for (int t = 0; t < numThreads; t++)
+	{
+		threads[t].queue = queues[sharedQueue ? 0 : t];
+		threads[t].start = &start;
+		threads[t].latencies = latencies + (size_t)t * COMMANDSPERTHREAD;
+		pthread_create(&handles[t], NULL, SubmitThreadMain, &threads[t]);
+	}
+
+	pthread_barrier_wait(&start);
+	double time = GetWallTime();
+	for (int t = 0; t < numThreads; t++)
+		pthread_join(handles[t], NULL);
+	for (int q = 0; q < numQueues; q++)
+		clFinish(queues[q]);
+	time = GetWallTime() - time;
+
+	for (int t = 0; t < numThreads; t++)
+	{
+		CheckOpenCLError(threads[t].err, __LINE__);
+#ifdef VERBOSE
+		double enqueueTime = 0.0;
+		for (int c = 0; c < COMMANDSPERTHREAD; c++)
+			enqueueTime += threads[t].latencies[c];
+		printf("------------- thread %2d, %8.6lf s in enqueue calls\n", t, enqueueTime);
+#endif
+	}
+	for (int q = 0; q < numQueues; q++)
+		clReleaseCommandQueue(queues[q]);
+	pthread_barrier_destroy(&start);
+	return time;
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], "-I.");
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
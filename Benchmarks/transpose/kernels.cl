@@ -0,0 +1,101 @@
+// enable extension for OpenCL 1.1 and lower
+#if __OPENCL_VERSION__ < 120
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+// Tiled kernels work on TILE_DIM x TILE_DIM tiles with TILE_DIM x BLOCK_ROWS work-groups,
+// every work-item handling TILE_DIM / BLOCK_ROWS rows. Both are set by the host with -D.
+#ifndef TILE_DIM
+#define TILE_DIM 32
+#endif
+#ifndef BLOCK_ROWS
+#define BLOCK_ROWS 8
+#endif
+
+// Matrices are row major, width columns by height rows. Transposes write a height x width matrix.
+#define TRANSPOSE_KERNELS(TYPENAME, TYPE)                                                   \
+                                                                                           \
+/* 2-D copy, one element per work-item */                                                  \
+__kernel void copy2D##TYPENAME(__global const TYPE * restrict in,                          \
+                               __global TYPE * restrict out,                               \
+                               const uint width,                                           \
+                               const uint height)                                          \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+                                                                                           \
+	out[y * width + x] = in[y * width + x];                                                \
+}                                                                                          \
+                                                                                           \
+/* Reads are coalesced, writes are height elements apart */                                \
+__kernel void transposeNaive##TYPENAME(__global const TYPE * restrict in,                  \
+                                       __global TYPE * restrict out,                       \
+                                       const uint width,                                   \
+                                       const uint height)                                  \
+{                                                                                          \
+	size_t x = get_global_id(0);                                                           \
+	size_t y = get_global_id(1);                                                           \
+                                                                                           \
+	out[x * height + y] = in[y * width + x];                                               \
+}                                                                                          \
+                                                                                           \
+/* Copy with the launch geometry and access pattern of the tiled transposes */             \
+__kernel void copyTiled##TYPENAME(__global const TYPE * restrict in,                       \
+                                  __global TYPE * restrict out,                            \
+                                  const uint width,                                        \
+                                  const uint height)                                       \
+{                                                                                          \
+	size_t x = get_group_id(0) * TILE_DIM + get_local_id(0);                               \
+	size_t y = get_group_id(1) * TILE_DIM + get_local_id(1);                               \
+                                                                                           \
+	for (int j = 0; j < TILE_DIM; j += BLOCK_ROWS)                                         \
+		out[(y + j) * width + x] = in[(y + j) * width + x];                                \
+}                                                                                          \
+                                                                                           \
+/* The tile goes through local memory so both reads and writes are coalesced */            \
+__kernel void transposeLocal##TYPENAME(__global const TYPE * restrict in,                  \
+                                       __global TYPE * restrict out,                       \
+                                       const uint width,                                   \
+                                       const uint height)                                  \
+{                                                                                          \
+	__local TYPE tile[TILE_DIM][TILE_DIM];                                                 \
+	size_t x = get_group_id(0) * TILE_DIM + get_local_id(0);                               \
+	size_t y = get_group_id(1) * TILE_DIM + get_local_id(1);                               \
+                                                                                           \
+	for (int j = 0; j < TILE_DIM; j += BLOCK_ROWS)                                         \
+		tile[get_local_id(1) + j][get_local_id(0)] = in[(y + j) * width + x];              \
+                                                                                           \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	x = get_group_id(1) * TILE_DIM + get_local_id(0);                                      \
+	y = get_group_id(0) * TILE_DIM + get_local_id(1);                                      \
+                                                                                           \
+	for (int j = 0; j < TILE_DIM; j += BLOCK_ROWS)                                         \
+		out[(y + j) * height + x] = tile[get_local_id(0)][get_local_id(1) + j];            \
+}                                                                                          \
+                                                                                           \
+/* Same, with one extra column so the column reads of the tile hit different banks */      \
+__kernel void transposeLocalPadded##TYPENAME(__global const TYPE * restrict in,            \
+                                             __global TYPE * restrict out,                 \
+                                             const uint width,                             \
+                                             const uint height)                            \
+{                                                                                          \
+	__local TYPE tile[TILE_DIM][TILE_DIM + 1];                                             \
+	size_t x = get_group_id(0) * TILE_DIM + get_local_id(0);                               \
+	size_t y = get_group_id(1) * TILE_DIM + get_local_id(1);                               \
+                                                                                           \
+	for (int j = 0; j < TILE_DIM; j += BLOCK_ROWS)                                         \
+		tile[get_local_id(1) + j][get_local_id(0)] = in[(y + j) * width + x];              \
+                                                                                           \
+	barrier(CLK_LOCAL_MEM_FENCE);                                                          \
+                                                                                           \
+	x = get_group_id(1) * TILE_DIM + get_local_id(0);                                      \
+	y = get_group_id(0) * TILE_DIM + get_local_id(1);                                      \
+                                                                                           \
+	for (int j = 0; j < TILE_DIM; j += BLOCK_ROWS)                                         \
+		out[(y + j) * height + x] = tile[get_local_id(0)][get_local_id(1) + j];            \
+}
+
+// copy2DDouble, transposeNaiveDouble, copyTiledDouble, transposeLocalDouble, transposeLocalPaddedDouble
+TRANSPOSE_KERNELS(Double, double)
+TRANSPOSE_KERNELS(Float, float)
@@ -0,0 +1,723 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h> // DBL_MIN
+
+/* clCreateCommandQueue with 2.0 headers gives a warning about it being deprecated, avoid it */
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+
+#include <CL/opencl.h>
+
+// OpenCL kernels, built once per tile shape
+const char *kernelFileName = "kernels.cl";
+
+// Number of times to run tests
+#define NTIMES 10
+
+// Side of the square matrix. Can be given as the first argument, must be a multiple of the largest TILE_DIM.
+#define TRYMATRIXSIZE 4096
+
+// Skinny matrices, width x height. Same number of elements as the default square matrix.
+#define SKINNYSHAPES {{65536, 256}, {256, 65536}}
+
+// Tile shapes for the tiled kernels, {TILE_DIM, BLOCK_ROWS}. The work-group is TILE_DIM x BLOCK_ROWS,
+// so TILE_DIM * BLOCK_ROWS must not go over the device max work-group size.
+#define TILESHAPES {{16, 16}, {16, 8}, {16, 4}, {32, 8}, {32, 4}, {64, 4}}
+
+// 2-D local sizes tested for the naive kernels, x by y
+#define LOCALSIZES2D {{256, 1}, {128, 2}, {64, 4}, {32, 8}, {16, 16}, {8, 32}, {4, 64}, {1, 256}}
+
+// For fast executions you can auto-select the device and platform and skip the scanf
+#define AUTOPLATFORM 0
+#define AUTODEVICE 0
+
+// Print per-local-size results during test?
+// #define VERBOSE
+
+// Function prototypes
+double GetWallTime(void);
+void RunMatrixTests(cl_context *context, cl_device_id device, cl_command_queue *queue, cl_program *program, size_t width, size_t height);
+void RunTest2D(cl_command_queue *queue, cl_kernel *kernel, char *testName, size_t width, size_t height, size_t rowsPerItem,
+			   const size_t (*localSizes)[2], int numLocalSizes, size_t dataType, cl_mem *in, cl_mem *out, int transposed);
+int VerifyMatrix(cl_command_queue *queue, cl_mem *in, cl_mem *out, size_t width, size_t height, size_t dataType, int transposed);
+
+// OpenCL Stuff
+int InitialiseCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *, cl_ulong *, cl_ulong *);
+void CleanUpCLEnvironment(cl_platform_id **, cl_device_id ***, cl_context *, cl_command_queue *, cl_program *);
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options);
+void CheckOpenCLError(cl_int err, int line);
+
+int main(int argc, char *argv[])
+{
+	// Disable caching of binaries by nvidia implementation
+	setenv("CUDA_CACHE_DISABLE", "1", 1);
+
+	// Set up OpenCL environment
+	cl_platform_id    *platform;
+	cl_device_id      **device_id;
+	cl_device_id      device;
+	cl_context        context;
+	cl_command_queue  queue;
+	cl_ulong          maxAlloc, globalMemSize;
+	cl_program        program;
+
+	if (InitialiseCLEnvironment(&platform, &device_id, &context, &queue, &program, &maxAlloc, &globalMemSize) == EXIT_FAILURE)
+	{
+		printf("Error initialising OpenCL environment\n");
+		return EXIT_FAILURE;
+	}
+	clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+
+	// If the user inputs a size, it will be used. Otherwise, the default size is used.
+	size_t matrixSize = TRYMATRIXSIZE;
+	if (argc == 2 && atoi(argv[1]) >= 64 && atoi(argv[1]) % 64 == 0)
+	{
+		matrixSize = (size_t)atoi(argv[1]);
+#ifdef VERBOSE
+		printf("Using matrix size of %zu\n", matrixSize);
+#endif
+	}
+
+	// Both matrices of doubles must fit in memory
+	while (matrixSize * matrixSize * sizeof(double) > maxAlloc || 2 * matrixSize * matrixSize * sizeof(double) > globalMemSize)
+	{
+		printf("Adjusting matrix size from %zu to %zu\n", matrixSize, matrixSize / 2);
+		matrixSize /= 2;
+	}
+
+	const size_t skinnyShapes[][2] = SKINNYSHAPES;
+
+	printf("-------------------------------------------------------------------------------------------------------------------\n");
+	printf("Function                    Matrix        Tile   Best Rate GB/s   Avg time   Min time   Max time   Best Local Size\n");
+	printf("-------------------------------------------------------------------------------------------------------------------\n");
+	RunMatrixTests(&context, device, &queue, &program, matrixSize, matrixSize);
+	for (int s = 0; s < (int)(sizeof(skinnyShapes) / sizeof(skinnyShapes[0])); s++)
+	{
+		if (skinnyShapes[s][0] * skinnyShapes[s][1] * sizeof(double) > maxAlloc)
+		{
+			printf("Skipping %zux%zu matrix, it is larger than the max allocation\n", skinnyShapes[s][0], skinnyShapes[s][1]);
+			continue;
+		}
+		RunMatrixTests(&context, device, &queue, &program, skinnyShapes[s][0], skinnyShapes[s][1]);
+	}
+
+	CleanUpCLEnvironment(&platform, &device_id, &context, &queue, &program);
+	return 0;
+}
+
+// Runs every kernel on a width x height matrix, for Doubles and Floats. The naive kernels are run with
+// every local size in LOCALSIZES2D, the tiled kernels are rebuilt and run for every shape in TILESHAPES.
+void RunMatrixTests(cl_context *context, cl_device_id device, cl_command_queue *queue, cl_program *program, size_t width, size_t height)
+{
+	const char *precisions[] = {"Double", "Float"};
+	const char *typeLetters[] = {"D", "F"};
+	const size_t typeSizes[] = {sizeof(cl_double), sizeof(cl_float)};
+	const size_t localSizes[][2] = LOCALSIZES2D;
+	const size_t tileShapes[][2] = TILESHAPES;
+	const int numLocalSizes = sizeof(localSizes) / sizeof(localSizes[0]);
+	const int numTileShapes = sizeof(tileShapes) / sizeof(tileShapes[0]);
+	const char *naiveKernels[] = {"copy2D", "transposeNaive"};
+	const char *tiledKernels[] = {"copyTiled", "transposeLocal", "transposeLocalPadded"};
+	size_t maxWorkGroupSize;
+	cl_ulong localMemSize;
+	char kernelName[64];
+	char testName[64];
+	char options[128];
+	cl_kernel kernel;
+	cl_mem in, out;
+	cl_int err;
+
+	clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize), &localMemSize, NULL);
+
+	for (int p = 0; p < 2; p++)
+	{
+		size_t sizeBytes = width * height * typeSizes[p];
+
+		// The input holds the element index, so every output element can be checked
+		void *hostIn = malloc(sizeBytes);
+		for (size_t i = 0; i < width * height; i++)
+		{
+			if (p == 0)
+				((double *)hostIn)[i] = (double)i;
+			else
+				((float *)hostIn)[i] = (float)i;
+		}
+		in = clCreateBuffer(*context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeBytes, hostIn, &err);
+		out = clCreateBuffer(*context, CL_MEM_READ_WRITE, sizeBytes, NULL, &err);
+		CheckOpenCLError(err, __LINE__);
+		free(hostIn);
+
+		for (int k = 0; k < 2; k++)
+		{
+			snprintf(kernelName, sizeof(kernelName), "%s%s", naiveKernels[k], precisions[p]);
+			snprintf(testName, sizeof(testName), "%s%s", naiveKernels[k], typeLetters[p]);
+			kernel = clCreateKernel(*program, kernelName, &err);
+			CheckOpenCLError(err, __LINE__);
+			RunTest2D(queue, &kernel, testName, width, height, 1, localSizes, numLocalSizes, typeSizes[p], &in, &out, k == 1);
+			clReleaseKernel(kernel);
+		}
+
+		for (int t = 0; t < numTileShapes; t++)
+		{
+			// Skip tiles that don't fit the work-group, the local memory (padded tile) or the matrix
+			if (tileShapes[t][0] * tileShapes[t][1] > maxWorkGroupSize ||
+				tileShapes[t][0] * (tileShapes[t][0] + 1) * typeSizes[p] > localMemSize ||
+				width % tileShapes[t][0] != 0 || height % tileShapes[t][0] != 0)
+				continue;
+
+			snprintf(options, sizeof(options), "-I. -DTILE_DIM=%zu -DBLOCK_ROWS=%zu", tileShapes[t][0], tileShapes[t][1]);
+			cl_program tiledProgram = BuildProgram(*context, device, options);
+			if (tiledProgram == NULL)
+				continue;
+
+			for (int k = 0; k < 3; k++)
+			{
+				snprintf(kernelName, sizeof(kernelName), "%s%s", tiledKernels[k], precisions[p]);
+				snprintf(testName, sizeof(testName), "%s%s", tiledKernels[k], typeLetters[p]);
+				kernel = clCreateKernel(tiledProgram, kernelName, &err);
+				CheckOpenCLError(err, __LINE__);
+				RunTest2D(queue, &kernel, testName, width, height, tileShapes[t][0] / tileShapes[t][1], &tileShapes[t], 1,
+						  typeSizes[p], &in, &out, k != 0);
+				clReleaseKernel(kernel);
+			}
+			clReleaseProgram(tiledProgram);
+		}
+		printf("-------------------------------------------------------------------------------------------------------------------\n");
+
+		clReleaseMemObject(in);
+		clReleaseMemObject(out);
+	}
+}
+
+// Runs the kernel NTIMES for every local size, with a width x (height / rowsPerItem) grid, and prints the best.
+// The output is checked against the input after the first launch.
+void RunTest2D(cl_command_queue *queue, cl_kernel *kernel, char *testName, size_t width, size_t height, size_t rowsPerItem,
+			   const size_t (*localSizes)[2], int numLocalSizes, size_t dataType, cl_mem *in, cl_mem *out, int transposed)
+{
+	const size_t globalSize[2] = {width, height / rowsPerItem};
+	size_t bestLocalSize[2] = {0, 0};
+	double bestTime = DBL_MAX, worstTime = DBL_MIN, totalTime = 0.0;
+	int numRuns = 0;
+	cl_uint w = width, h = height;
+	cl_int err;
+
+	err = clSetKernelArg(*kernel, 0, sizeof(cl_mem), in);
+	err |= clSetKernelArg(*kernel, 1, sizeof(cl_mem), out);
+	err |= clSetKernelArg(*kernel, 2, sizeof(cl_uint), &w);
+	err |= clSetKernelArg(*kernel, 3, sizeof(cl_uint), &h);
+	CheckOpenCLError(err, __LINE__);
+
+	for (int l = 0; l < numLocalSizes; l++)
+	{
+		const size_t *localSize = localSizes[l];
+		if (globalSize[0] % localSize[0] != 0 || globalSize[1] % localSize[1] != 0)
+			continue;
+
+		// Check the output of the first launch
+		if (numRuns == 0)
+		{
+			const cl_uint zero = 0;
+			err = clEnqueueFillBuffer(*queue, *out, &zero, sizeof(zero), 0, width * height * dataType, 0, NULL, NULL);
+			err |= clEnqueueNDRangeKernel(*queue, *kernel, 2, NULL, globalSize, localSize, 0, NULL, NULL);
+			CheckOpenCLError(err, __LINE__);
+			if (!VerifyMatrix(queue, in, out, width, height, dataType, transposed))
+				printf("Error in %s, wrong output for the %zux%zu matrix!\n", testName, width, height);
+		}
+
+		double time = GetWallTime();
+
+		for (int n = 0; n < NTIMES; n++)
+		{
+			err = clEnqueueNDRangeKernel(*queue, *kernel, 2, NULL, globalSize, localSize, 0, NULL, NULL);
+		}
+		clFinish(*queue);
+		CheckOpenCLError(err, __LINE__);
+
+		time = GetWallTime() - time;
+		if (time < bestTime)
+		{
+			bestTime = time;
+			bestLocalSize[0] = localSize[0];
+			bestLocalSize[1] = localSize[1];
+		}
+		if (time > worstTime)
+		{
+			worstTime = time;
+		}
+		totalTime += time;
+		numRuns++;
+
+#ifdef VERBOSE
+		printf("------------- localSize = %3zux%-3zu, bandwidth = %7.3lf GB/s\n",
+			   localSize[0], localSize[1], 2 * NTIMES * width * height * dataType / 1024.0 / 1024.0 / 1024.0 / (time));
+#endif
+	}
+
+	if (numRuns == 0)
+	{
+		printf("%-20s   no local size divides the %zux%zu grid\n", testName, globalSize[0], globalSize[1]);
+		return;
+	}
+
+	// Tiled kernels show their tile shape, TILE_DIM x BLOCK_ROWS
+	char matrix[32], tile[16];
+	snprintf(matrix, sizeof(matrix), "%zux%zu", width, height);
+	if (rowsPerItem > 1 || numLocalSizes == 1)
+		snprintf(tile, sizeof(tile), "%zux%zu", localSizes[0][0], localSizes[0][1]);
+	else
+		snprintf(tile, sizeof(tile), "-");
+
+	// Every element is read once and written once
+	printf("%-20s   %13s   %9s   %14.3lf   %8.6lf   %8.6lf   %8.6lf   %9zux%-5zu\n",
+		   testName, matrix, tile, 2 * NTIMES * width * height * dataType / 1024.0 / 1024.0 / 1024.0 / bestTime,
+		   totalTime / (NTIMES * numRuns), bestTime, worstTime, bestLocalSize[0], bestLocalSize[1]);
+}
+
+// Returns 1 if out is a copy (or the transpose) of in
+int VerifyMatrix(cl_command_queue *queue, cl_mem *in, cl_mem *out, size_t width, size_t height, size_t dataType, int transposed)
+{
+	char *hostIn = malloc(width * height * dataType);
+	char *hostOut = malloc(width * height * dataType);
+	int correct = 1;
+
+	clEnqueueReadBuffer(*queue, *in, CL_TRUE, 0, width * height * dataType, hostIn, 0, NULL, NULL);
+	clEnqueueReadBuffer(*queue, *out, CL_TRUE, 0, width * height * dataType, hostOut, 0, NULL, NULL);
+
+	for (size_t y = 0; y < height && correct; y++)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			size_t outIdx = transposed ? x * height + y : y * width + x;
+			if (memcmp(hostIn + (y * width + x) * dataType, hostOut + outIdx * dataType, dataType) != 0)
+			{
+				correct = 0;
+				break;
+			}
+		}
+	}
+
+	free(hostIn);
+	free(hostOut);
+	return correct;
+}
+
+// Return ns accurate walltime
+double GetWallTime(void)
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_REALTIME, &tv);
+	return (double)tv.tv_sec + 1e-9 * (double)tv.tv_nsec;
+}
+
+// OpenCL functions
+int InitialiseCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program, cl_ulong *maxAlloc, cl_ulong *globalMemSize)
+{
+	// error flag
+	cl_int err;
+	char infostring[1024];
+
+	// get platform and device information
+	cl_uint numPlatforms;
+	err = clGetPlatformIDs(0, NULL, &numPlatforms);
+	*platform = calloc(numPlatforms, sizeof(cl_platform_id));
+	*device_id = calloc(numPlatforms, sizeof(cl_device_id *));
+	err |= clGetPlatformIDs(numPlatforms, *platform, NULL);
+	CheckOpenCLError(err, __LINE__);
+	cl_uint *numDevices;
+	numDevices = calloc(numPlatforms, sizeof(cl_uint));
+
+	// Retrieves information about the platform, and for each platform, about the devices.
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		clGetPlatformInfo((*platform)[i], CL_PLATFORM_VENDOR, sizeof(infostring), infostring, NULL);
+		printf("\n---OpenCL: Platform Vendor %d: %s\n", i, infostring);
+
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, 0, NULL, &(numDevices[i]));
+		if (err == CL_DEVICE_NOT_FOUND)
+			continue;
+		CheckOpenCLError(err, __LINE__);
+		(*device_id)[i] = malloc(numDevices[i] * sizeof(cl_device_id));
+		err = clGetDeviceIDs((*platform)[i], CL_DEVICE_TYPE_ALL, numDevices[i], (*device_id)[i], NULL);
+		CheckOpenCLError(err, __LINE__);
+		for (cl_uint j = 0; j < numDevices[i]; j++)
+		{
+			char deviceName[200];
+			cl_device_fp_config doublePrecisionSupport = 0;
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+			printf("---OpenCL:    Device found %d. %s\n", j, deviceName);
+
+			cl_ulong maxAlloc;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAlloc), &maxAlloc, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_MAX_MEM_ALLOC_SIZE: %lu MB\n", maxAlloc / 1024 / 1024);
+#endif
+
+			cl_uint cacheLineSize;
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, sizeof(cacheLineSize), &cacheLineSize, NULL);
+#ifdef VERBOSE
+			printf("---OpenCL:       CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE: %u B\n", cacheLineSize);
+#endif
+
+			clGetDeviceInfo((*device_id)[i][j], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(doublePrecisionSupport), &doublePrecisionSupport, NULL);
+			if (doublePrecisionSupport == 0)
+				printf("---OpenCL:        Device %d does not support double precision!\n", j);
+		}
+	}
+
+	// Get platform from user:
+	cl_long chosenPlatform = -1;
+	if (numPlatforms == 1)
+	{
+		chosenPlatform = 0;
+		printf("Auto-selecting platform %lu.\n", chosenPlatform);
+	}
+	else
+		while (chosenPlatform < 0)
+		{
+#ifdef AUTOPLATFORM
+			chosenPlatform = AUTOPLATFORM;
+			printf("Auto-selecting platform %lu.\n", chosenPlatform);
+#else
+			printf("\nChoose a platform: ");
+			(void)!scanf("%ld", &chosenPlatform);
+#endif
+			if (chosenPlatform > (numPlatforms - 1) || chosenPlatform < 0)
+			{
+				chosenPlatform = -1;
+				printf("Invalid platform.\n");
+			}
+			if (numDevices[chosenPlatform] < 1)
+			{
+				chosenPlatform = -1;
+				printf("Platform has no devices.\n");
+			}
+		}
+
+	// Get device from user:
+	cl_long chosenDevice = -1;
+	if (numDevices[chosenPlatform] == 1)
+	{
+		chosenDevice = 0;
+		printf("Auto-selecting device %lu.\n", chosenDevice);
+	}
+	else
+		while (chosenDevice < 0)
+		{
+#ifdef AUTODEVICE
+			chosenDevice = AUTODEVICE;
+			printf("Auto-selecting device %lu.\n", chosenDevice);
+#else
+			printf("Choose a device: ");
+			(void)!scanf("%ld", &chosenDevice);
+#endif
+			if (chosenDevice > (numDevices[chosenPlatform] - 1) || chosenDevice < 0)
+			{
+				chosenDevice = -1;
+				printf("Invalid device.\n");
+			}
+		}
+	printf("\n");
+
+	// store global mem size and max allocation size
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(*globalMemSize), globalMemSize, NULL);
+	clGetDeviceInfo((*device_id)[chosenPlatform][chosenDevice], CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(*maxAlloc), maxAlloc, NULL);
+
+	// create a context
+	*context = clCreateContext(NULL, 1, &((*device_id)[chosenPlatform][chosenDevice]), NULL, NULL, &err);
+	CheckOpenCLError(err, __LINE__);
+	// create a queue
+	*queue = clCreateCommandQueue(*context, (*device_id)[chosenPlatform][chosenDevice], 0, &err);
+	CheckOpenCLError(err, __LINE__);
+
+	// create and build the program
+	*program = BuildProgram(*context, (*device_id)[chosenPlatform][chosenDevice], "-I.");
+	if (*program == NULL)
+		return EXIT_FAILURE;
+
+	free(numDevices);
+	return EXIT_SUCCESS;
+}
+
+// Reads kernelFileName and builds it for the given device. Returns NULL on failure.
+cl_program BuildProgram(cl_context context, cl_device_id device, const char *options)
+{
+	cl_program program;
+	cl_int err;
+
+	// get kernel from file
+	FILE *kernelFile = fopen(kernelFileName, "rb");
+	if (kernelFile == NULL)
+	{
+		printf("Error opening kernel file %s, line %d\n", kernelFileName, __LINE__);
+		return NULL;
+	}
+	fseek(kernelFile, 0, SEEK_END);
+	long fileLength = ftell(kernelFile);
+	rewind(kernelFile);
+	char *kernelSource = malloc(fileLength * sizeof(char));
+	long read = fread(kernelSource, sizeof(char), fileLength, kernelFile);
+	if (fileLength != read)
+		printf("Error reading kernel file, line %d\n", __LINE__);
+	fclose(kernelFile);
+
+	// create the program with the source above
+#ifdef VERBOSE
+	printf("Creating CL Program...\n");
+#endif
+	size_t sourceLength = fileLength;
+	program = clCreateProgramWithSource(context, 1, (const char **)&kernelSource, &sourceLength, &err);
+	free(kernelSource);
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clCreateProgramWithSource: %d, line %d.\n", err, __LINE__);
+		return NULL;
+	}
+
+	// build program executable
+#ifdef VERBOSE
+	printf("Building CL Executable (%s)...\n", options);
+#endif
+	err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+
+	if (err != CL_SUCCESS)
+	{
+		printf("Error in clBuildProgram: %d, line %d.\n", err, __LINE__);
+		char buffer[5000];
+		clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
+		printf("%s\n", buffer);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	return program;
+}
+
+void CleanUpCLEnvironment(cl_platform_id **platform, cl_device_id ***device_id, cl_context *context, cl_command_queue *queue, cl_program *program)
+{
+	// release CL resources
+	clReleaseProgram(*program);
+	clReleaseCommandQueue(*queue);
+	clReleaseContext(*context);
+
+	cl_uint numPlatforms;
+	clGetPlatformIDs(0, NULL, &numPlatforms);
+	for (cl_uint i = 0; i < numPlatforms; i++)
+	{
+		free((*device_id)[i]);
+	}
+	free(*platform);
+	free(*device_id);
+}
+
+void CheckOpenCLError(cl_int err, int line)
+{
+	if (err != CL_SUCCESS)
+	{
+		char *errString;
+
+		switch (err)
+		{
+		case 0:
+			errString = "CL_SUCCESS";
+			break;
+		case -1:
+			errString = "CL_DEVICE_NOT_FOUND";
+			break;
+		case -2:
+			errString = "CL_DEVICE_NOT_AVAILABLE";
+			break;
+		case -3:
+			errString = "CL_COMPILER_NOT_AVAILABLE";
+			break;
+		case -4:
+			errString = "CL_MEM_OBJECT_ALLOCATION_FAILURE";
+			break;
+		case -5:
+			errString = "CL_OUT_OF_RESOURCES";
+			break;
+		case -6:
+			errString = "CL_OUT_OF_HOST_MEMORY";
+			break;
+		case -7:
+			errString = "CL_PROFILING_INFO_NOT_AVAILABLE";
+			break;
+		case -8:
+			errString = "CL_MEM_COPY_OVERLAP";
+			break;
+		case -9:
+			errString = "CL_IMAGE_FORMAT_MISMATCH";
+			break;
+		case -10:
+			errString = "CL_IMAGE_FORMAT_NOT_SUPPORTED";
+			break;
+		case -11:
+			errString = "CL_BUILD_PROGRAM_FAILURE";
+			break;
+		case -12:
+			errString = "CL_MAP_FAILURE";
+			break;
+		case -13:
+			errString = "CL_MISALIGNED_SUB_BUFFER_OFFSET";
+			break;
+		case -14:
+			errString = "CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST";
+			break;
+		case -15:
+			errString = "CL_COMPILE_PROGRAM_FAILURE";
+			break;
+		case -16:
+			errString = "CL_LINKER_NOT_AVAILABLE";
+			break;
+		case -17:
+			errString = "CL_LINK_PROGRAM_FAILURE";
+			break;
+		case -18:
+			errString = "CL_DEVICE_PARTITION_FAILED";
+			break;
+		case -19:
+			errString = "CL_KERNEL_ARG_INFO_NOT_AVAILABLE";
+			break;
+		case -30:
+			errString = "CL_INVALID_VALUE";
+			break;
+		case -31:
+			errString = "CL_INVALID_DEVICE_TYPE";
+			break;
+		case -32:
+			errString = "CL_INVALID_PLATFORM";
+			break;
+		case -33:
+			errString = "CL_INVALID_DEVICE";
+			break;
+		case -34:
+			errString = "CL_INVALID_CONTEXT";
+			break;
+		case -35:
+			errString = "CL_INVALID_QUEUE_PROPERTIES";
+			break;
+		case -36:
+			errString = "CL_INVALID_COMMAND_QUEUE";
+			break;
+		case -37:
+			errString = "CL_INVALID_HOST_PTR";
+			break;
+		case -38:
+			errString = "CL_INVALID_MEM_OBJECT";
+			break;
+		case -39:
+			errString = "CL_INVALID_IMAGE_FORMAT_DESCRIPTOR";
+			break;
+		case -40:
+			errString = "CL_INVALID_IMAGE_SIZE";
+			break;
+		case -41:
+			errString = "CL_INVALID_SAMPLER";
+			break;
+		case -42:
+			errString = "CL_INVALID_BINARY";
+			break;
+		case -43:
+			errString = "CL_INVALID_BUILD_OPTIONS";
+			break;
+		case -44:
+			errString = "CL_INVALID_PROGRAM";
+			break;
+		case -45:
+			errString = "CL_INVALID_PROGRAM_EXECUTABLE";
+			break;
+		case -46:
+			errString = "CL_INVALID_KERNEL_NAME";
+			break;
+		case -47:
+			errString = "CL_INVALID_KERNEL_DEFINITION";
+			break;
+		case -48:
+			errString = "CL_INVALID_KERNEL";
+			break;
+		case -49:
+			errString = "CL_INVALID_ARG_INDEX";
+			break;
+		case -50:
+			errString = "CL_INVALID_ARG_VALUE";
+			break;
+		case -51:
+			errString = "CL_INVALID_ARG_SIZE";
+			break;
+		case -52:
+			errString = "CL_INVALID_KERNEL_ARGS";
+			break;
+		case -53:
+			errString = "CL_INVALID_WORK_DIMENSION";
+			break;
+		case -54:
+			errString = "CL_INVALID_WORK_GROUP_SIZE";
+			break;
+		case -55:
+			errString = "CL_INVALID_WORK_ITEM_SIZE";
+			break;
+		case -56:
+			errString = "CL_INVALID_GLOBAL_OFFSET";
+			break;
+		case -57:
+			errString = "CL_INVALID_EVENT_WAIT_LIST";
+			break;
+		case -58:
+			errString = "CL_INVALID_EVENT";
+			break;
+		case -59:
+			errString = "CL_INVALID_OPERATION";
+			break;
+		case -60:
+			errString = "CL_INVALID_GL_OBJECT";
+			break;
+		case -61:
+			errString = "CL_INVALID_BUFFER_SIZE";
+			break;
+		case -62:
+			errString = "CL_INVALID_MIP_LEVEL";
+			break;
+		case -63:
+			errString = "CL_INVALID_GLOBAL_WORK_SIZE";
+			break;
+		case -64:
+			errString = "CL_INVALID_PROPERTY";
+			break;
+		case -65:
+			errString = "CL_INVALID_IMAGE_DESCRIPTOR";
+			break;
+		case -66:
+			errString = "CL_INVALID_COMPILER_OPTIONS";
+			break;
+		case -67:
+			errString = "CL_INVALID_LINKER_OPTIONS";
+			break;
+		case -68:
+			errString = "CL_INVALID_DEVICE_PARTITION_COUNT";
+			break;
+		case -1000:
+			errString = "CL_INVALID_GL_SHAREGROUP_REFERENCE_KHR";
+			break;
+		case -1001:
+			errString = "CL_PLATFORM_NOT_FOUND_KHR";
+			break;
+		case -1002:
+			errString = "CL_INVALID_D3D10_DEVICE_KHR";
+			break;
+		case -1003:
+			errString = "CL_INVALID_D3D10_RESOURCE_KHR";
+			break;
+		case -1004:
+			errString = "CL_D3D10_RESOURCE_ALREADY_ACQUIRED_KHR";
+			break;
+		case -1005:
+			errString = "CL_D3D10_RESOURCE_NOT_ACQUIRED_KHR";
+			break;
+		default:
+			errString = "Unknown OpenCL error";
+		}
+		printf("OpenCL Error %d (%s), line %d\n", err, errString, line);
+	}
+}
@@ -7,4 +7,4 @@
 # You can find the location of OpenCL with (be at your root /):
 # find . -name "libOpenCL.so" > ~/opencl.txt | grep -v "Permission denied"
 
-cc -O2 -Wall -o $1.out $1.c -L/opt/rocm-5.2.3/opencl/lib -lOpenCL
\ No newline at end of file
+cc -O2 -Wall -pthread -o $1.out $1.c -L/opt/rocm-5.2.3/opencl/lib -lOpenCL
\ No newline at end of file